@@ -0,0 +1,402 @@
+#include "board.h"
+#include "trace.h"
+#include <string.h>
+
+static const char BOARD_INDEX_MAGIC[4] = { 'C', 'R', 'I', 'X' };
+#define BOARD_INDEX_VERSION 1
+
+// Cabeçalho do .idx (entradas logo depois, na ordem de bytes da máquina: o arquivo é mapeado direto)
+typedef struct BoardIndexHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t count;                 // entradas no índice
+    uint32_t covered;               // registros do .dat já incluídos (os seguintes vão para a cauda)
+} BoardIndexHeader;
+
+/* -------------------------------------------------------
+   ÍNDICE MAPEADO
+ ------------------------------------------------------- */
+static void index_unmap(Board *board)
+{
+    utils_unmap_file(&board->index);
+    board->entries = NULL;
+    board->index_count = 0;
+}
+
+// Retorna quantos registros o índice cobre (0 se não existe ou é inválido)
+static uint32_t index_map(Board *board)
+{
+    index_unmap(board);
+    if (!utils_map_file(board->idx_path, &board->index) || !board->index.data) return 0;
+
+    const BoardIndexHeader *h = (const BoardIndexHeader *)board->index.data;
+    long long expected = (long long)sizeof(*h);
+    if (board->index.size >= expected) expected += (long long)h->count * (long long)sizeof(BoardEntry);
+    if (board->index.size < (long long)sizeof(*h) || memcmp(h->magic, BOARD_INDEX_MAGIC, 4) != 0 ||
+        h->version != BOARD_INDEX_VERSION || board->index.size != expected || h->covered > board->record_count) {
+        index_unmap(board);
+        return 0;
+    }
+    board->entries = h->count ? (const BoardEntry *)(h + 1) : NULL;
+    board->index_count = h->count;
+    return h->covered;
+}
+
+// Ordem do placar: pontuação decrescente, depois o registro mais antigo
+static int entry_before(const BoardEntry *a, const BoardEntry *b)
+{
+    if (a->score != b->score) return a->score > b->score;
+    return a->record < b->record;
+}
+
+/**
+ * Intercala índice + cauda num índice novo e troca o arquivo
+ * Só leitura sequencial do mapeamento e escrita bufferizada: memória constante
+ */
+static int index_merge(Board *board)
+{
+    TRACE_BEGIN("board_merge");
+    char tmp_path[BOARD_PATH_LEN + 8];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", board->idx_path);
+    FILE *f = fopen(tmp_path, "wb");
+    if (!f) {
+        TRACE_END("board_merge");
+        return 0;
+    }
+
+    BoardIndexHeader h;
+    memcpy(h.magic, BOARD_INDEX_MAGIC, 4);
+    h.version = BOARD_INDEX_VERSION;
+    h.count = board->index_count + (uint32_t)board->tail_count;
+    // Índice + cauda são sempre os registros 0..count-1 (o que está sendo acrescentado ainda não entrou)
+    h.covered = h.count;
+    int ok = fwrite(&h, sizeof(h), 1, f) == 1;
+
+    uint32_t i = 0;
+    int t = 0;
+    while (ok && (i < board->index_count || t < board->tail_count)) {
+        const BoardEntry *e;
+        if (t >= board->tail_count || (i < board->index_count && entry_before(&board->entries[i], &board->tail[t]))) {
+            e = &board->entries[i++];
+        } else {
+            e = &board->tail[t++];
+        }
+        ok = fwrite(e, sizeof(*e), 1, f) == 1;
+    }
+    if (ok) ok = utils_fsync_file(f);
+    if (fclose(f) != 0) ok = 0;
+
+    // O Windows não troca um arquivo mapeado: solta o mapeamento antes
+    index_unmap(board);
+    if (ok) ok = utils_replace_file(tmp_path, board->idx_path);
+    if (!ok) remove(tmp_path);
+
+    index_map(board);
+    if (ok) board->tail_count = 0;
+    TRACE_END("board_merge");
+    return ok;
+}
+
+static int tail_insert(Board *board, int32_t score, uint32_t record)
+{
+    // Só leitura: quem grava intercala antes de passar de BOARD_TAIL_MAX, então não enche
+    if (board->tail_count == BOARD_TAIL_MAX && (board->read_only || !index_merge(board))) return 0;
+
+    // Registro novo é o mais recente: vai depois de todos com a mesma pontuação
+    int lo = 0, hi = board->tail_count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (board->tail[mid].score >= score) lo = mid + 1;
+        else hi = mid;
+    }
+    memmove(&board->tail[lo + 1], &board->tail[lo], (size_t)(board->tail_count - lo) * sizeof(BoardEntry));
+    board->tail[lo] = (BoardEntry){ score, record };
+    board->tail_count++;
+    return 1;
+}
+
+/* -------------------------------------------------------
+   ABRIR / FECHAR
+ ------------------------------------------------------- */
+void board_base_path(char *out, int size, const char *ranking_file)
+{
+    if (!out || size <= 0) return;
+    const char *name = ranking_file ? ranking_file : "ranking";
+    int len = (int)strlen(name);
+    // Só a extensão do arquivo (um ponto depois da última barra)
+    for (int i = len - 1; i >= 0 && name[i] != '/' && name[i] != '\\'; --i) {
+        if (name[i] == '.') {
+            len = i;
+            break;
+        }
+    }
+    snprintf(out, (size_t)size, "%.*s", len, name);
+}
+
+static int open_board(Board *board, const char *base_path, int read_only)
+{
+    if (!board || !base_path) return 0;
+    memset(board, 0, sizeof(*board));
+    snprintf(board->dat_path, sizeof(board->dat_path), "%s.dat", base_path);
+    snprintf(board->idx_path, sizeof(board->idx_path), "%s.idx", base_path);
+
+    board->read_only = read_only;
+    if (read_only) {
+        board->records = fopen(board->dat_path, "rb");
+    } else {
+        board->records = fopen(board->dat_path, "r+b");
+        if (!board->records) board->records = fopen(board->dat_path, "w+b");
+    }
+    if (!board->records) return 0;
+
+    // Registro cortado no fim (crash no meio do fwrite) não conta: o próximo acréscimo sobrescreve
+    fseek(board->records, 0, SEEK_END);
+    long size = ftell(board->records);
+    board->record_count = size > 0 ? (uint32_t)(size / (long)sizeof(BoardRecord)) : 0;
+
+    // Registros que o índice ainda não cobre voltam para a cauda
+    uint32_t covered = index_map(board);
+    for (uint32_t r = covered; r < board->record_count; ++r) {
+        int32_t score;
+        if (fseek(board->records, (long)r * (long)sizeof(BoardRecord), SEEK_SET) != 0 ||
+            fread(&score, sizeof(score), 1, board->records) != 1 ||
+            !tail_insert(board, score, r)) {
+            board_close(board);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int board_open(Board *board, const char *base_path)
+{
+    return open_board(board, base_path, 0);
+}
+
+int board_open_read(Board *board, const char *base_path)
+{
+    return open_board(board, base_path, 1);
+}
+
+void board_close(Board *board)
+{
+    if (!board) return;
+    // Cauda pendente vira índice: o próximo open não precisa reler registros
+    if (board->records && board->tail_count > 0 && !board->read_only) index_merge(board);
+    index_unmap(board);
+    if (board->records) fclose(board->records);
+    board->records = NULL;
+    board->tail_count = 0;
+}
+
+/* -------------------------------------------------------
+   ESCRITA
+ ------------------------------------------------------- */
+int board_add(Board *board, const BoardRecord *record)
+{
+    if (!board || !board->records || !record || board->read_only) return 0;
+
+    if (fseek(board->records, (long)board->record_count * (long)sizeof(BoardRecord), SEEK_SET) != 0 ||
+        fwrite(record, sizeof(*record), 1, board->records) != 1 ||
+        fflush(board->records) != 0) {
+        return 0;
+    }
+    uint32_t index = board->record_count++;
+    return tail_insert(board, record->score, index);
+}
+
+int board_sync(Board *board)
+{
+    return board && board->records && utils_fsync_file(board->records);
+}
+
+/* -------------------------------------------------------
+   CONSTRUÇÃO EM ORDEM
+ ------------------------------------------------------- */
+static void build_tmp_path(char *out, int size, const char *path)
+{
+    snprintf(out, (size_t)size, "%s.tmp", path);
+}
+
+int board_build_start(BoardBuilder *builder, const char *base_path)
+{
+    if (!builder || !base_path) return 0;
+    memset(builder, 0, sizeof(*builder));
+    snprintf(builder->dat_path, sizeof(builder->dat_path), "%s.dat", base_path);
+    snprintf(builder->idx_path, sizeof(builder->idx_path), "%s.idx", base_path);
+
+    char tmp[BOARD_PATH_LEN + 8];
+    build_tmp_path(tmp, sizeof(tmp), builder->dat_path);
+    builder->records = fopen(tmp, "wb");
+    build_tmp_path(tmp, sizeof(tmp), builder->idx_path);
+    builder->index = fopen(tmp, "wb");
+
+    // Cabeçalho provisório: count/covered só são conhecidos no fim
+    BoardIndexHeader h;
+    memset(&h, 0, sizeof(h));
+    if (!builder->records || !builder->index || fwrite(&h, sizeof(h), 1, builder->index) != 1) {
+        board_build_abort(builder);
+        return 0;
+    }
+    return 1;
+}
+
+int board_build_add(BoardBuilder *builder, const BoardRecord *record)
+{
+    if (!builder || !builder->records || !record) return 0;
+    if (builder->count > 0 && record->score > builder->last_score) return 0;
+
+    BoardEntry e = { record->score, builder->count };
+    if (fwrite(record, sizeof(*record), 1, builder->records) != 1 ||
+        fwrite(&e, sizeof(e), 1, builder->index) != 1) {
+        return 0;
+    }
+    builder->count++;
+    builder->last_score = record->score;
+    return 1;
+}
+
+int board_build_finish(BoardBuilder *builder)
+{
+    if (!builder || !builder->records) return 0;
+    BoardIndexHeader h;
+    memcpy(h.magic, BOARD_INDEX_MAGIC, 4);
+    h.version = BOARD_INDEX_VERSION;
+    h.count = builder->count;
+    h.covered = builder->count;
+
+    int ok = fseek(builder->index, 0, SEEK_SET) == 0 && fwrite(&h, sizeof(h), 1, builder->index) == 1;
+    if (ok) ok = utils_fsync_file(builder->records) && utils_fsync_file(builder->index);
+    if (fclose(builder->records) != 0) ok = 0;
+    if (fclose(builder->index) != 0) ok = 0;
+    builder->records = builder->index = NULL;
+
+    // .dat primeiro: sem o .idx novo, o placar ainda abre (os registros voltam para a cauda)
+    char tmp[BOARD_PATH_LEN + 8];
+    build_tmp_path(tmp, sizeof(tmp), builder->dat_path);
+    if (ok) ok = utils_replace_file(tmp, builder->dat_path);
+    build_tmp_path(tmp, sizeof(tmp), builder->idx_path);
+    if (ok) ok = utils_replace_file(tmp, builder->idx_path);
+    if (!ok) board_build_abort(builder);
+    return ok;
+}
+
+void board_build_abort(BoardBuilder *builder)
+{
+    if (!builder) return;
+    if (builder->records) fclose(builder->records);
+    if (builder->index) fclose(builder->index);
+    builder->records = builder->index = NULL;
+
+    char tmp[BOARD_PATH_LEN + 8];
+    build_tmp_path(tmp, sizeof(tmp), builder->dat_path);
+    remove(tmp);
+    build_tmp_path(tmp, sizeof(tmp), builder->idx_path);
+    remove(tmp);
+}
+
+/* -------------------------------------------------------
+   CONSULTAS
+ ------------------------------------------------------- */
+uint32_t board_count(const Board *board)
+{
+    return board ? board->index_count + (uint32_t)board->tail_count : 0;
+}
+
+void board_cursor_start(BoardCursor *cursor)
+{
+    if (!cursor) return;
+    cursor->index_pos = 0;
+    cursor->tail_pos = 0;
+}
+
+void board_cursor_seek(const Board *board, BoardCursor *cursor, uint32_t pos)
+{
+    if (!board || !cursor) return;
+    uint32_t tail_count = (uint32_t)board->tail_count;
+    if (pos > board->index_count + tail_count) pos = board->index_count + tail_count;
+
+    // As pos primeiras são index[0..i) + tail[0..pos-i): menor i com index[i] não antes de tail[pos-i-1]
+    uint32_t lo = pos > tail_count ? pos - tail_count : 0;
+    uint32_t hi = pos < board->index_count ? pos : board->index_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (entry_before(&board->entries[mid], &board->tail[pos - mid - 1])) lo = mid + 1;
+        else hi = mid;
+    }
+    cursor->index_pos = lo;
+    cursor->tail_pos = (int)(pos - lo);
+}
+
+int board_cursor_next(const Board *board, BoardCursor *cursor, BoardEntry *out)
+{
+    if (!board || !cursor || !out) return 0;
+    uint32_t i = cursor->index_pos;
+    int t = cursor->tail_pos;
+    if (i >= board->index_count && t >= board->tail_count) return 0;
+    if (t >= board->tail_count || (i < board->index_count && entry_before(&board->entries[i], &board->tail[t]))) {
+        *out = board->entries[cursor->index_pos++];
+    } else {
+        *out = board->tail[cursor->tail_pos++];
+    }
+    return 1;
+}
+
+int board_top(const Board *board, int k, BoardEntry *out)
+{
+    if (!board || !out) return 0;
+    BoardCursor cursor;
+    board_cursor_start(&cursor);
+    int n = 0;
+    while (n < k && board_cursor_next(board, &cursor, &out[n])) n++;
+    return n;
+}
+
+uint32_t board_rank_of(const Board *board, int score)
+{
+    if (!board) return 0;
+    // Primeira posição com pontuação <= score, no índice e na cauda
+    uint32_t lo = 0, hi = board->index_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (board->entries[mid].score > score) lo = mid + 1;
+        else hi = mid;
+    }
+    int tlo = 0, thi = board->tail_count;
+    while (tlo < thi) {
+        int mid = tlo + (thi - tlo) / 2;
+        if (board->tail[mid].score > score) tlo = mid + 1;
+        else thi = mid;
+    }
+    return lo + (uint32_t)tlo;
+}
+
+static void count_score(uint32_t *counts, int buckets, int32_t score)
+{
+    if (score < 0) score = 0;
+    if (score >= buckets) score = buckets - 1;
+    counts[score]++;
+}
+
+void board_score_counts(const Board *board, uint32_t *counts, int buckets)
+{
+    if (!counts || buckets <= 0) return;
+    memset(counts, 0, (size_t)buckets * sizeof(*counts));
+    if (!board) return;
+    for (uint32_t i = 0; i < board->index_count; ++i) count_score(counts, buckets, board->entries[i].score);
+    for (int t = 0; t < board->tail_count; ++t) count_score(counts, buckets, board->tail[t].score);
+}
+
+int board_read_record(Board *board, uint32_t record, BoardRecord *out)
+{
+    return board_read_records(board, record, out, 1) == 1;
+}
+
+int board_read_records(Board *board, uint32_t first, BoardRecord *out, int max)
+{
+    if (!board || !board->records || !out || max <= 0 || first >= board->record_count) return 0;
+    uint32_t left = board->record_count - first;
+    if ((uint32_t)max > left) max = (int)left;
+    if (fseek(board->records, (long)first * (long)sizeof(BoardRecord), SEEK_SET) != 0) return 0;
+    return (int)fread(out, sizeof(*out), (size_t)max, board->records);
+}
@@ -0,0 +1,151 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include "utils.h"
+#include <stdio.h>
+#include <stdint.h>
+
+// Placar em disco com todas as partidas já jogadas (milhões), sem limite de MAX_SCORES.
+//
+// - <base>.dat: registros de tamanho fixo (BoardRecord), só acrescentados. É a fonte da verdade.
+//   Gravado pelo jogo, está na ordem de chegada; montado de uma vez (board_build_*), na ordem
+//   do placar. A ordem das partidas é a de BoardRecord.time, não a do .dat.
+// - <base>.idx: índice ordenado (pontuação decrescente; empate = partida mais antiga primeiro),
+//   8 bytes por partida, lido por mmap. Top-K e posição de uma pontuação saem dele sem carregar nada.
+// - Cauda: as partidas mais novas ficam num array ordenado em memória (BOARD_TAIL_MAX).
+//   Inserção = busca binária na cauda; cauda cheia = intercala índice + cauda num índice novo
+//   (leitura sequencial do mapeamento, temporário + troca atômica).
+// Memória fixa: cauda + buffers; o resto são páginas do mapeamento que o SO pode descartar.
+//
+// Crash: um registro cortado no fim do .dat é sobrescrito no próximo acréscimo, e o cabeçalho
+// do índice diz quantos registros ele cobre; os que faltam voltam para a cauda ao abrir.
+
+#define BOARD_TAIL_MAX 4096
+#define BOARD_PATH_LEN 512
+
+typedef struct BoardRecord {
+    int32_t score;
+    uint32_t time;                  // time(NULL) do fim da partida; 0 = desconhecida (importado do ranking.txt)
+    uint32_t seed;                  // 0 = desconhecida (importado do ranking.txt)
+    uint16_t mode;                  // modo de jogo (0 = padrão)
+    uint16_t flags;
+    uint32_t name;                  // id do nome na tabela de nomes (names.h, <base>.names)
+} BoardRecord;                      // 20 bytes
+
+typedef struct BoardEntry {
+    int32_t score;
+    uint32_t record;                // posição do registro no .dat
+} BoardEntry;
+
+typedef struct Board {
+    char dat_path[BOARD_PATH_LEN];
+    char idx_path[BOARD_PATH_LEN];
+    FILE *records;
+    uint32_t record_count;
+
+    UtilsMapping index;             // cabeçalho + entradas
+    const BoardEntry *entries;      // dentro do mapeamento (NULL se vazio)
+    uint32_t index_count;
+
+    BoardEntry tail[BOARD_TAIL_MAX];
+    int tail_count;
+    int read_only;                  // board_open_read: nunca escreve (nem intercala ao fechar)
+} Board;
+
+/**
+ * Abre (ou cria) o placar
+ * @param base_path Caminho sem extensão (ex.: "ranking" -> ranking.dat / ranking.idx)
+ * @return 0 se não deu para abrir o .dat
+ */
+int board_open(Board *board, const char *base_path);
+void board_close(Board *board);
+
+/**
+ * Abre um placar que outro Board (ex.: a thread de escrita) está gravando, só para ler
+ * Foto do momento: partidas acrescentadas depois não aparecem. Não cria nada nem escreve no .idx.
+ * @return 0 se o placar não existe
+ */
+int board_open_read(Board *board, const char *base_path);
+
+// Acrescenta a partida (registro no .dat + cauda). Retorna 0 em erro de escrita
+int board_add(Board *board, const BoardRecord *record);
+
+// Força os registros para o disco (fsync)
+int board_sync(Board *board);
+
+// Total de partidas no placar
+uint32_t board_count(const Board *board);
+
+/**
+ * As k melhores partidas (índice intercalado com a cauda, O(k))
+ * @return Quantas foram escritas em out
+ */
+int board_top(const Board *board, int k, BoardEntry *out);
+
+// Leitura em ordem do placar inteiro (índice intercalado com a cauda), uma entrada por vez
+typedef struct BoardCursor {
+    uint32_t index_pos;
+    int tail_pos;
+} BoardCursor;
+
+void board_cursor_start(BoardCursor *cursor);
+
+// Põe o cursor na posição pos (0-based) da ordem do placar, O(log n): o próximo next devolve ela
+void board_cursor_seek(const Board *board, BoardCursor *cursor, uint32_t pos);
+
+/**
+ * Próxima entrada na ordem do placar (pontuação decrescente, depois a partida mais antiga)
+ * @return 0 quando acabou
+ */
+int board_cursor_next(const Board *board, BoardCursor *cursor, BoardEntry *out);
+
+// Quantas partidas têm pontuação maior que score (posição 0-based de score no placar). O(log n)
+uint32_t board_rank_of(const Board *board, int score);
+
+/**
+ * Quantas partidas fizeram cada pontuação (varre índice + cauda uma vez, em sequência)
+ * @param counts Zerado aqui; pontuações fora de 0..buckets-1 vão para o primeiro/último balde
+ */
+void board_score_counts(const Board *board, uint32_t *counts, int buckets);
+
+int board_read_record(Board *board, uint32_t record, BoardRecord *out);
+
+/**
+ * Lê registros em sequência, na ordem do .dat (de chegada, ou a do placar se veio de board_build_*)
+ * Dentro de uma pontuação é sempre a mais antiga primeiro.
+ * @return Quantos foram lidos (0 = acabou)
+ */
+int board_read_records(Board *board, uint32_t first, BoardRecord *out, int max);
+
+// Placar novo escrito de uma vez, já na ordem do placar (junção de placares, pedaços ordenados):
+// .dat e .idx saem em sequência, sem cauda nem intercalação. O .dat fica na ordem do placar, não
+// na de chegada (quem precisa dela olha BoardRecord.time). Tudo vai para temporários e só
+// aparece no lugar em board_build_finish.
+typedef struct BoardBuilder {
+    char dat_path[BOARD_PATH_LEN];
+    char idx_path[BOARD_PATH_LEN];
+    FILE *records;                  // <base>.dat.tmp
+    FILE *index;                    // <base>.idx.tmp
+    uint32_t count;
+    int32_t last_score;
+} BoardBuilder;
+
+// Retorna 0 se não deu para criar os temporários
+int board_build_start(BoardBuilder *builder, const char *base_path);
+
+/**
+ * Acrescenta a próxima partida (registro k do .dat = entrada k do índice)
+ * @return 0 em erro de escrita ou fora de ordem (pontuação maior que a anterior)
+ */
+int board_build_add(BoardBuilder *builder, const BoardRecord *record);
+
+// fsync + troca dos dois arquivos. Retorna 0 em erro (os temporários são apagados)
+int board_build_finish(BoardBuilder *builder);
+
+// Desiste: apaga os temporários
+void board_build_abort(BoardBuilder *builder);
+
+// Tira a extensão do caminho do ranking ("ranking.txt" -> "ranking")
+void board_base_path(char *out, int size, const char *ranking_file);
+
+#endif // BOARD_H
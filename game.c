@@ -1,7 +1,7 @@
 // game.c
 #include "game.h"
 #include "utils.h"
-#include "raylib.h"  // Para GetFrameTime()
+#include "trace.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -9,21 +9,20 @@
 
 /* -------------------------------------------------------
    CONFIG GERAL
-   - Mapa desce sozinho a cada SCROLL_TICKS frames.
+   - Mapa desce sozinho a cada SCROLL_TICKS ticks (game.h).
    - Player se move livre (WASD), não é ancorado.
  ------------------------------------------------------- */
-#define SCROLL_TICKS 120   // ajuste a velocidade do scroll vertical
 
 /* -------------------------------------------------------
    FORWARD DECLS
  ------------------------------------------------------- */
-static void fill_row_with_gaps(CircularQueue *q, char obstacle,
-                               int obsMin, int obsMax,
-                               int gapMin, int gapMax);
-static RowType generate_row_type(int world_position);
-static void create_obstacles(CircularQueue *queue, RowType type);
+static int game_random_int(GameState *state, int min_value, int max_value);
+static void lane_bank_init(void);
+static RowType generate_row_type(GameState *state, int world_position);
+static void create_obstacles(GameState *state, CircularQueue *queue, RowType type);
 static void generate_row(Row *row, int world_position, GameState *state);
 static void row_destroy(Row *row);
+static void make_grass_row(Row *row);
 static void ensure_safe_area(GameState *state);
 static void scroll_world_down(GameState *state);
 static void move_rows(GameState *state);
@@ -35,34 +34,102 @@ static void handle_death(GameState *state);
 static void collect_life_power(GameState *state);
 
 /* -------------------------------------------------------
-   PREENCHIMENTO COM OBSTÁCULOS + GAPSF
+   ALEATÓRIO POR PARTIDA
+   - xorshift32 guardado no próprio GameState: a mesma semente
+     gera o mesmo mundo em qualquer máquina/build, e o estado do
+     gerador entra no hash de determinismo.
  ------------------------------------------------------- */
-static void fill_row_with_gaps(CircularQueue *q, char obstacle,
-                               int obsMin, int obsMax,
-                               int gapMin, int gapMax)
+static unsigned int game_next_random(GameState *state)
+{
+    unsigned int x = state->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state->rng = x;
+    return x;
+}
+
+static int game_random_int(GameState *state, int min_value, int max_value)
+{
+    if (max_value <= min_value) return min_value;
+    if (!state) return utils_random_int(min_value, max_value);
+    unsigned int span = (unsigned int)(max_value - min_value) + 1u;
+    return min_value + (int)(game_next_random(state) % span);
+}
+
+/* -------------------------------------------------------
+   BANCO DE PADRÕES DE FAIXA
+   - Cada variante de estrada/rio (create_obstacles) tem
+     LANE_BANK_SIZE faixas prontas, geradas uma vez com semente
+     fixa (o banco é igual em qualquer máquina).
+   - Faixa nova = índice + rotação sorteados e uma escrita em
+     bloco (queue_set_cells), em vez de sortear segmento por
+     segmento e andar a lista a cada célula.
+ ------------------------------------------------------- */
+#define LANE_BANK_SIZE 32
+#define LANE_VARIANTS 3
+#define LANE_BANK_SEED 0x2545F491u
+
+typedef struct LanePattern {
+    char obstacle;
+    int obsMin, obsMax;
+    int gapMin, gapMax;
+} LanePattern;
+
+// [0] = estrada, [1] = rio; mesmas variantes que create_obstacles sempre teve
+static const LanePattern lane_patterns[2][LANE_VARIANTS] = {
+    { { CHAR_CAR, 1, 2, 4, 7 }, { CHAR_CAR, 2, 3, 3, 5 }, { CHAR_CAR, 3, 4, 2, 4 } },
+    { { CHAR_LOG, 2, 3, 3, 5 }, { CHAR_LOG, 3, 4, 2, 4 }, { CHAR_LOG, 4, 5, 1, 3 } },
+};
+
+static char lane_bank[2][LANE_VARIANTS][LANE_BANK_SIZE][MAP_WIDTH];
+static int lane_bank_ready = 0;
+
+static int bank_random_int(unsigned int *rng, int min_value, int max_value)
+{
+    unsigned int x = *rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *rng = x;
+    return min_value + (int)(x % (unsigned int)(max_value - min_value + 1));
+}
+
+// Obstáculos e gaps alternados a partir da célula 0 (mesmo algoritmo do antigo fill_row_with_gaps)
+static void fill_cells_with_gaps(char *cells, int length, const LanePattern *p, unsigned int *rng)
 {
-    if (!q || q->length <= 0) return;
     int i = 0;
-    while (i < q->length) {
-        int obsLen = utils_random_int(obsMin, obsMax);
-        int gapLen = utils_random_int(gapMin, gapMax);
+    while (i < length) {
+        int obsLen = bank_random_int(rng, p->obsMin, p->obsMax);
+        int gapLen = bank_random_int(rng, p->gapMin, p->gapMax);
 
-        for (int k = 0; k < obsLen && i < q->length; ++k) {
-            queue_set_cell(q, i++, obstacle);
-        }
-        for (int k = 0; k < gapLen && i < q->length; ++k) {
-            queue_set_cell(q, i++, ' ');
+        for (int k = 0; k < obsLen && i < length; ++k) cells[i++] = p->obstacle;
+        for (int k = 0; k < gapLen && i < length; ++k) cells[i++] = ' ';
+    }
+}
+
+// Chamado pelo game_init (antes de a thread de simulação existir)
+static void lane_bank_init(void)
+{
+    if (lane_bank_ready) return;
+    unsigned int rng = LANE_BANK_SEED;
+    for (int lane = 0; lane < 2; ++lane) {
+        for (int v = 0; v < LANE_VARIANTS; ++v) {
+            for (int i = 0; i < LANE_BANK_SIZE; ++i) {
+                fill_cells_with_gaps(lane_bank[lane][v][i], MAP_WIDTH, &lane_patterns[lane][v], &rng);
+            }
         }
     }
+    lane_bank_ready = 1;
 }
 
 /* -------------------------------------------------------
    TIPO DE LINHA
  ------------------------------------------------------- */
-static RowType generate_row_type(int world_position)
+static RowType generate_row_type(GameState *state, int world_position)
 {
     if (world_position < 5) return ROW_GRASS; // respiro inicial
-    int roll = utils_random_int(0, 99);
+    int roll = game_random_int(state, 0, 99);
     if (roll < 40) return ROW_GRASS; // 40%
     if (roll < 70) return ROW_ROAD;  // 30%
     return ROW_RIVER;                 // 30%
@@ -71,7 +138,7 @@ static RowType generate_row_type(int world_position)
 /* -------------------------------------------------------
    GERA OBSTÁCULOS DA LINHA
  ------------------------------------------------------- */
-static void create_obstacles(CircularQueue *queue, RowType type)
+static void create_obstacles(GameState *state, CircularQueue *queue, RowType type)
 {
     if (!queue) return;
 
@@ -80,21 +147,12 @@ static void create_obstacles(CircularQueue *queue, RowType type)
         return;
     }
 
-    if (type == ROW_ROAD) {
-        int pattern = utils_random_int(0, 2);
-        if (pattern == 0)      fill_row_with_gaps(queue, CHAR_CAR, 1, 2, 4, 7);
-        else if (pattern == 1) fill_row_with_gaps(queue, CHAR_CAR, 2, 3, 3, 5);
-        else                   fill_row_with_gaps(queue, CHAR_CAR, 3, 4, 2, 4);
-        return;
-    }
-
-    if (type == ROW_RIVER) {
-        int pattern = utils_random_int(0, 2);
-        if (pattern == 0)      fill_row_with_gaps(queue, CHAR_LOG, 2, 3, 3, 5);
-        else if (pattern == 1) fill_row_with_gaps(queue, CHAR_LOG, 3, 4, 2, 4);
-        else                   fill_row_with_gaps(queue, CHAR_LOG, 4, 5, 1, 3);
-        return;
-    }
+    // Estrada ou rio: variante, faixa do banco e rotação, copiadas de uma vez
+    int lane = (type == ROW_ROAD) ? 0 : 1;
+    int variant = game_random_int(state, 0, LANE_VARIANTS - 1);
+    int index = game_random_int(state, 0, LANE_BANK_SIZE - 1);
+    int rotation = game_random_int(state, 0, MAP_WIDTH - 1);
+    queue_set_cells(queue, lane_bank[lane][variant][index], MAP_WIDTH, rotation);
 }
 
 /* -------------------------------------------------------
@@ -104,44 +162,41 @@ static void generate_row(Row *row, int world_position, GameState *state)
 {
     if (!row) return;
 
-    RowType type = generate_row_type(world_position);
+    RowType type = generate_row_type(state, world_position);
     row->type = type;
-    row->queue = queue_create(MAP_WIDTH);
+    // Reaproveita a fila que veio junto (scroll recicla a linha que saiu por baixo);
+    // todas as células são reescritas em create_obstacles
+    if (row->queue && row->queue->length != MAP_WIDTH) row_destroy(row);
+    if (!row->queue) row->queue = queue_create(MAP_WIDTH);
     if (!row->queue) {
         row->type = ROW_GRASS;
         row->queue = queue_create(MAP_WIDTH);
         if (!row->queue) return;
     }
 
-    row->direction = (utils_random_int(0, 1) == 0) ? -1 : 1;
+    row->direction = (game_random_int(state, 0, 1) == 0) ? -1 : 1;
 
     int baseMin = 15, baseMax = 25;
     int accel = world_position / 20;     // acelera suave com o progresso
     if (baseMin - accel < 8)  baseMin = 8;
     if (baseMax - accel < 12) baseMax = 12;
 
-    row->speed_ticks = utils_random_int(baseMin, baseMax);
+    row->speed_ticks = game_random_int(state, baseMin, baseMax);
     row->tick_counter = 0;
     row->moved_this_tick = 0;            // <<-- IMPORTANTE: inicia zerado
 
-    create_obstacles(row->queue, type);
+    create_obstacles(state, row->queue, type);
     
     // Sistema de vidas: gera poder de vida periodicamente (apenas modo 1 jogador)
     // IMPORTANTE: Só gera coração em linhas de grama para evitar obstáculos
     if (state && !state->two_players && world_position > 0 && type == ROW_GRASS) {
         // Verifica se já existe um poder de vida no mapa
         int has_life_power = 0;
-        for (int y = 0; y < MAP_HEIGHT; ++y) {
-            if (state->rows[y].queue) {
-                for (int x = 0; x < MAP_WIDTH; ++x) {
-                    if (queue_get_cell(state->rows[y].queue, x) == CHAR_LIFE) {
-                        has_life_power = 1;
-                        break;
-                    }
-                }
-                if (has_life_power) break;
-            }
+        for (int y = 0; y < MAP_HEIGHT && !has_life_power; ++y) {
+            // Uma passada por fila (queue_get_cell por célula andaria a lista de novo a cada x)
+            if (queue_count_char(state->rows[y].queue, CHAR_LIFE) > 0) has_life_power = 1;
         }
+        if (row != &state->incoming && queue_count_char(state->incoming.queue, CHAR_LIFE) > 0) has_life_power = 1;
         
         // Se não há poder de vida no mapa, verifica se deve gerar um novo
         // Usa life_power_spawned como contador de linhas de grama desde o último coração
@@ -153,7 +208,7 @@ static void generate_row(Row *row, int world_position, GameState *state)
             // Usa valor aleatório para variar o intervalo
             int spawn_interval = 8 + (world_position % 5); // Entre 8 e 12 linhas
             if (state->life_power_spawned >= spawn_interval) {
-                int life_x = utils_random_int(0, MAP_WIDTH - 1);
+                int life_x = game_random_int(state, 0, MAP_WIDTH - 1);
                 // Verifica se a posição está vazia (deve estar, pois é grama, mas por segurança)
                 char cell = queue_get_cell(row->queue, life_x);
                 if (cell == ' ' || cell == CHAR_GRASS) {
@@ -176,6 +231,18 @@ static void row_destroy(Row *row)
     }
 }
 
+// Transforma a linha em grama vazia, reaproveitando a fila que ela já tem
+static void make_grass_row(Row *row)
+{
+    row->type = ROW_GRASS;
+    if (!row->queue) row->queue = queue_create(MAP_WIDTH);
+    row->direction = 0;
+    row->speed_ticks = 0;
+    row->tick_counter = 0;
+    row->moved_this_tick = 0;
+    queue_fill_pattern(row->queue, ' ', 1, ' ', 1);
+}
+
 /* -------------------------------------------------------
    ÁREA SEGURA (APENAS NO INÍCIO)
    - início: 3 linhas seguras (apenas nas primeiras 20 linhas)
@@ -192,28 +259,14 @@ static void ensure_safe_area(GameState *state)
         // Força grama nas últimas 3 linhas apenas no início
         for (int y = MAP_HEIGHT - safe_lines; y < MAP_HEIGHT; ++y) {
             if (state->rows[y].type != ROW_GRASS) {
-                row_destroy(&state->rows[y]);
-                state->rows[y].type = ROW_GRASS;
-                state->rows[y].queue = queue_create(MAP_WIDTH);
-                state->rows[y].direction = 0;
-                state->rows[y].speed_ticks = 0;
-                state->rows[y].tick_counter = 0;
-                state->rows[y].moved_this_tick = 0;
-                queue_fill_pattern(state->rows[y].queue, ' ', 1, ' ', 1);
+                make_grass_row(&state->rows[y]);
             }
         }
 
         // Evita rio em cima de rio no começo (depois libera)
         for (int y = 0; y < MAP_HEIGHT - 1; ++y) {
             if (state->rows[y].type == ROW_RIVER && state->rows[y + 1].type == ROW_RIVER) {
-                row_destroy(&state->rows[y + 1]);
-                state->rows[y + 1].type = ROW_GRASS;
-                state->rows[y + 1].queue = queue_create(MAP_WIDTH);
-                state->rows[y + 1].direction = 0;
-                state->rows[y + 1].speed_ticks = 0;
-                state->rows[y + 1].tick_counter = 0;
-                state->rows[y + 1].moved_this_tick = 0;
-                queue_fill_pattern(state->rows[y + 1].queue, ' ', 1, ' ', 1);
+                make_grass_row(&state->rows[y + 1]);
             }
         }
     }
@@ -231,15 +284,20 @@ static void ensure_safe_area(GameState *state)
     if (!state) return;
 
     // --- DESCE TODAS AS LINHAS (SCROLL) ---
+    // A fila da linha que sai por baixo vira a fila da próxima linha a entrar:
+    // o scroll não aloca nem libera nós
+    CircularQueue *recycled = state->rows[MAP_HEIGHT - 1].queue;
     for (int y = MAP_HEIGHT - 1; y > 0; --y) {
-        row_destroy(&state->rows[y]);          // libera memória da linha atual
         state->rows[y] = state->rows[y - 1];   // copia a linha de cima para baixo
-        state->rows[y - 1].queue = NULL;       // evita ponteiro duplicado (double free)
     }
 
-    // --- GERA UMA NOVA LINHA NO TOPO ---
-    row_destroy(&state->rows[0]);              // libera topo antigo (se houver)
-    generate_row(&state->rows[0], state->world_position, state); // cria nova linha de mundo
+    // --- A LINHA QUE JÁ ESTAVA ENTRANDO VAI PARA O TOPO; GERA A PRÓXIMA ---
+    // Gerada um scroll antes: o render desenha ela entrando durante o scroll interpolado
+    state->rows[0] = state->incoming;
+    state->incoming.queue = recycled;          // evita ponteiro duplicado (a de cima já desceu)
+    TRACE_BEGIN("generate_row");
+    generate_row(&state->incoming, state->world_position + 1, state); // cria nova linha de mundo
+    TRACE_END("generate_row");
 
     // --- ZERA FLAGS DE MOVIMENTO (scroll não conta como "mover linha") ---
     for (int y = 0; y < MAP_HEIGHT; ++y) {
@@ -306,16 +364,47 @@ static void ensure_safe_area(GameState *state)
 /* -------------------------------------------------------
    INIT / RESET
  ------------------------------------------------------- */
+unsigned int game_make_seed(void)
+{
+    // Relógio de parede + monotônico: partidas seguidas não repetem a semente
+    unsigned int seed = (unsigned int)time(NULL) * 2654435761u;
+    seed ^= (unsigned int)(utils_now_seconds() * 1e6);
+    return seed ? seed : 1u;
+}
+
+unsigned int game_daily_seed(void)
+{
+    // Dia desde a época, espalhado pelo mesmo mix do xorshift (dias seguidos não dão mundos parecidos)
+    unsigned int seed = (unsigned int)(time(NULL) / 86400) * 2654435761u + 0x5EED5EEDu;
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed ? seed : 1u;
+}
+
  void game_init(GameState *state, int width)
+ {
+     game_init_seeded(state, width, game_make_seed());
+ }
+
+ void game_init_seeded(GameState *state, int width, unsigned int seed)
  {
      if (!state) return;
  
+     // xorshift não sai do zero
+     state->seed = seed;
+     state->rng = seed ? seed : 0x9E3779B9u;
      state->world_position = 0;
+     lane_bank_init();
  
      // Gera o buffer inicial de linhas visíveis
+     // (as filas são sempre novas: o estado pode chegar aqui sem inicializar)
      for (int y = 0; y < MAP_HEIGHT; ++y) {
+         state->rows[y].queue = NULL;
          generate_row(&state->rows[y], y, state);
      }
+     state->incoming.queue = NULL;
+     generate_row(&state->incoming, MAP_HEIGHT, state);
  
      ensure_safe_area(state);
  
@@ -339,6 +428,7 @@ static void ensure_safe_area(GameState *state)
      // Outros controles
      state->world_position = MAP_HEIGHT; // mantém seu comportamento original
      state->just_scrolled  = 0;          // nenhum scroll ocorreu ainda
+     state->scroll_timer   = 0;          // relógio do scroll começa zerado a cada partida
      
     // Sistema de vidas
     state->vidas = 1;                    // Começa com 1 vida
@@ -372,38 +462,90 @@ static void ensure_safe_area(GameState *state)
  
 
 void game_reset(GameState *state)
+{
+    if (!state) return;
+    game_destroy(state);
+    game_init(state, MAP_WIDTH);
+}
+
+void game_destroy(GameState *state)
 {
     if (!state) return;
     for (int y = 0; y < MAP_HEIGHT; ++y) {
         row_destroy(&state->rows[y]);
     }
-    game_init(state, MAP_WIDTH);
+    row_destroy(&state->incoming);
+}
+
+/* -------------------------------------------------------
+   SNAPSHOT
+   - Copia os campos escalares e o conteúdo das filas,
+     reaproveitando as filas já alocadas em dst.
+ ------------------------------------------------------- */
+// Conteúdo de from numa fila de dst (own, reaproveitada se tiver o mesmo tamanho)
+static CircularQueue *copy_queue(CircularQueue *own, const CircularQueue *from, int *ok)
+{
+    if (!from) {
+        if (own) queue_destroy(own);
+        return NULL;
+    }
+    if (own && own->length != from->length) {
+        queue_destroy(own);
+        own = NULL;
+    }
+    if (!own) own = queue_create(from->length);
+    if (!own) *ok = 0;
+    else queue_copy_cells(own, from);
+    return own;
+}
+
+int game_copy_state(GameState *dst, const GameState *src)
+{
+    if (!dst || !src || dst == src) return 0;
+
+    // Guarda as filas de dst antes de copiar os campos (a cópia sobrescreve os ponteiros)
+    CircularQueue *own[MAP_HEIGHT];
+    for (int y = 0; y < MAP_HEIGHT; ++y) own[y] = dst->rows[y].queue;
+    CircularQueue *own_incoming = dst->incoming.queue;
+
+    *dst = *src;
+
+    int ok = 1;
+    for (int y = 0; y < MAP_HEIGHT; ++y) {
+        dst->rows[y].queue = copy_queue(own[y], src->rows[y].queue, &ok);
+    }
+    dst->incoming.queue = copy_queue(own_incoming, src->incoming.queue, &ok);
+    return ok;
 }
 
 /* -------------------------------------------------------
    MOVE AS LINHAS (ROTAÇÃO DAS FILAS)
    - Marca moved_this_tick=1 somente quando rotaciona.
  ------------------------------------------------------- */
-static void move_rows(GameState *state)
+static void move_row(Row *row)
 {
-    for (int y = 0; y < MAP_HEIGHT; ++y) {
-        Row *row = &state->rows[y];
+    if (!row->queue || row->type == ROW_GRASS) {
+        row->moved_this_tick = 0;
+        return;
+    }
 
-        if (!row->queue || row->type == ROW_GRASS) {
-            row->moved_this_tick = 0;
-            continue;
-        }
+    row->tick_counter++;
+    if (row->tick_counter >= row->speed_ticks) {
+        row->tick_counter = 0;
+        if (row->direction < 0) queue_rotate_left(row->queue);
+        else                    queue_rotate_right(row->queue);
+        row->moved_this_tick = 1;  // <<-- moveu AGORA
+    } else {
+        row->moved_this_tick = 0;  // <<-- não moveu
+    }
+}
 
-        row->tick_counter++;
-        if (row->tick_counter >= row->speed_ticks) {
-            row->tick_counter = 0;
-            if (row->direction < 0) queue_rotate_left(row->queue);
-            else                    queue_rotate_right(row->queue);
-            row->moved_this_tick = 1;  // <<-- moveu AGORA
-        } else {
-            row->moved_this_tick = 0;  // <<-- não moveu
-        }
+static void move_rows(GameState *state)
+{
+    for (int y = 0; y < MAP_HEIGHT; ++y) {
+        move_row(&state->rows[y]);
     }
+    move_row(&state->incoming);    // já anda: entra no topo sem pular
 }
 
 /* -------------------------------------------------------
@@ -480,16 +622,7 @@ static void handle_death(GameState *state)
     // Se não encontrou grama, força a última linha a ser grama (fallback de segurança)
     if (safe_y == -1) {
         safe_y = MAP_HEIGHT - 1;
-        row_destroy(&state->rows[safe_y]);
-        state->rows[safe_y].type = ROW_GRASS;
-        state->rows[safe_y].queue = queue_create(MAP_WIDTH);
-        state->rows[safe_y].direction = 0;
-        state->rows[safe_y].speed_ticks = 0;
-        state->rows[safe_y].tick_counter = 0;
-        state->rows[safe_y].moved_this_tick = 0;
-        if (state->rows[safe_y].queue) {
-            queue_fill_pattern(state->rows[safe_y].queue, ' ', 1, ' ', 1);
-        }
+        make_grass_row(&state->rows[safe_y]);
     }
     
     // Reposiciona o jogador no centro da linha de grama encontrada
@@ -634,8 +767,8 @@ static void check_collision_player(GameState *state, Player *player)
      
      // Sistema de renascimento: pausa o jogo durante o renascimento (apenas modo 1 jogador)
      if (state->renascendo && !state->two_players) {
-         // Decrementa o timer
-         state->renascer_timer -= GetFrameTime();
+         // Decrementa o timer (1 tick fixo)
+         state->renascer_timer -= 1.0f / GAME_TICK_HZ;
          
          // Quando o timer chega a 0, termina o renascimento
          if (state->renascer_timer <= 0.0f) {
@@ -652,16 +785,19 @@ static void check_collision_player(GameState *state, Player *player)
      }
  
      // 1) Scroll vertical por tempo
-     static int scroll_timer = 0;
-     scroll_timer++;
-     if (scroll_timer >= SCROLL_TICKS) {
-         scroll_timer = 0;
+     state->scroll_timer++;
+     if (state->scroll_timer >= SCROLL_TICKS) {
+         state->scroll_timer = 0;
  
          // FAZ O SCROLL
+         TRACE_BEGIN("scroll_world_down");
          scroll_world_down(state);
+         TRACE_END("scroll_world_down");
  
          // Checa colisão após reposicionar o mundo
+         TRACE_BEGIN("check_collision");
          check_collision(state);
+         TRACE_END("check_collision");
  
          // Damos um frame de respiro: nada de mover linhas/empurrar neste frame
          state->just_scrolled = 1;
@@ -708,7 +844,9 @@ static void check_collision_player(GameState *state, Player *player)
          }
          
          // 2) Agora mova todas as linhas (rotaciona carros/troncos)
+         TRACE_BEGIN("move_rows");
          move_rows(state);
+         TRACE_END("move_rows");
          
          // 3) Empurra ambos os jogadores se necessário (após a rotação)
          if (will_push_p1 && state->p1.alive) {
@@ -742,7 +880,9 @@ static void check_collision_player(GameState *state, Player *player)
          }
 
          // 2) Agora mova todas as linhas (rotaciona carros/troncos)
+         TRACE_BEGIN("move_rows");
          move_rows(state);
+         TRACE_END("move_rows");
 
          // 3) Se precisava empurrar, empurre AGORA (imediatamente após a rotação)
          if (will_push) {
@@ -753,12 +893,151 @@ static void check_collision_player(GameState *state, Player *player)
      }
  
      // 4) Colisão do frame
+     TRACE_BEGIN("check_collision");
      check_collision(state);
+     TRACE_END("check_collision");
  
      // Libera o “respiro” para os próximos frames
      state->just_scrolled = 0;
  }
 
+/* -------------------------------------------------------
+   HASH DE DETERMINISMO
+   - FNV-1a campo a campo (nunca sobre a struct inteira: padding
+     e ponteiros mudariam entre builds).
+ ------------------------------------------------------- */
+#define FNV32_OFFSET 2166136261u
+#define FNV32_PRIME  16777619u
+
+static uint32_t hash_bytes(uint32_t h, const void *data, size_t len)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= FNV32_PRIME;
+    }
+    return h;
+}
+
+static uint32_t hash_int(uint32_t h, int value)
+{
+    // Sempre little-endian, para o hash não depender da máquina
+    unsigned char b[4];
+    uint32_t v = (uint32_t)value;
+    b[0] = (unsigned char)v; b[1] = (unsigned char)(v >> 8);
+    b[2] = (unsigned char)(v >> 16); b[3] = (unsigned char)(v >> 24);
+    return hash_bytes(h, b, 4);
+}
+
+static uint32_t hash_player(uint32_t h, const Player *p)
+{
+    h = hash_int(h, p->x);
+    h = hash_int(h, p->y);
+    h = hash_int(h, p->alive);
+    h = hash_int(h, p->score);
+    h = hash_int(h, p->min_abs_reached);
+    h = hash_int(h, p->last_abs);
+    return hash_int(h, p->advanced_this_tick);
+}
+
+void game_hash(const GameState *state, GameHash *out)
+{
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!state) return;
+
+    uint32_t lanes = FNV32_OFFSET, phases = FNV32_OFFSET;
+    for (int y = 0; y <= MAP_HEIGHT; ++y) {
+        const Row *row = y < MAP_HEIGHT ? &state->rows[y] : &state->incoming;   // a que está entrando por último
+        lanes = hash_int(lanes, row->type);
+        lanes = hash_int(lanes, row->direction);
+        lanes = hash_int(lanes, row->speed_ticks);
+
+        // Percorre os nós direto: queue_get_cell faria a lista ser andada uma vez por célula
+        const CircularQueue *q = row->queue;
+        if (q && q->head) {
+            const Node *n = q->head;
+            for (int x = 0; x < q->length; ++x, n = n->next) lanes = hash_bytes(lanes, &n->data, 1);
+        }
+
+        phases = hash_int(phases, row->tick_counter);
+        phases = hash_int(phases, row->moved_this_tick);
+    }
+    phases = hash_int(phases, state->scroll_timer);
+    phases = hash_int(phases, state->just_scrolled);
+
+    uint32_t players = FNV32_OFFSET;
+    players = hash_int(players, state->player_x);
+    players = hash_int(players, state->player_y);
+    players = hash_int(players, state->score);
+    players = hash_int(players, state->game_over);
+    players = hash_int(players, state->min_abs_reached);
+    players = hash_int(players, state->last_abs);
+    players = hash_int(players, state->advanced_this_tick);
+    players = hash_int(players, state->two_players);
+    players = hash_player(players, &state->p1);
+    players = hash_player(players, &state->p2);
+
+    // renascer_timer é float: entra pelos bits, que precisam bater exatamente
+    uint32_t timer_bits;
+    memcpy(&timer_bits, &state->renascer_timer, sizeof(timer_bits));
+    uint32_t lives = FNV32_OFFSET;
+    lives = hash_int(lives, state->vidas);
+    lives = hash_int(lives, state->renascendo);
+    lives = hash_int(lives, (int)timer_bits);
+    lives = hash_int(lives, state->life_power_spawned);
+
+    out->fields[GAME_HASH_LANES]   = lanes;
+    out->fields[GAME_HASH_PHASES]  = phases;
+    out->fields[GAME_HASH_PLAYERS] = players;
+    out->fields[GAME_HASH_LIVES]   = lives;
+    out->fields[GAME_HASH_RNG]     = hash_int(FNV32_OFFSET, (int)state->rng);
+    out->fields[GAME_HASH_WORLD]   = hash_int(hash_int(FNV32_OFFSET, state->world_position), state->world_head);
+
+    // Total em 64 bits sobre os hashes dos campos
+    uint64_t total = 14695981039346656037ull;
+    for (int i = 0; i < GAME_HASH_FIELD_COUNT; ++i) {
+        for (int k = 0; k < 4; ++k) {
+            total ^= (out->fields[i] >> (8 * k)) & 0xFFu;
+            total *= 1099511628211ull;
+        }
+    }
+    out->total = total;
+}
+
+const char *game_hash_field_name(GameHashField field)
+{
+    static const char *names[GAME_HASH_FIELD_COUNT] = {
+        "lanes", "phases", "players", "lives", "rng", "world"
+    };
+    return (field >= 0 && field < GAME_HASH_FIELD_COUNT) ? names[field] : "?";
+}
+
+/* -------------------------------------------------------
+   INTERPOLAÇÃO PARA O RENDER
+   - A lógica só anda em células inteiras; o render usa estas
+     frações para desenhar o movimento entre um tick e outro.
+------------------------------------------------------- */
+float game_row_offset(const Row *row, float alpha)
+{
+    if (!row || !row->queue || row->type == ROW_GRASS || row->speed_ticks <= 0) return 0.0f;
+
+    float frac = ((float)row->tick_counter + alpha) / (float)row->speed_ticks;
+    if (frac < 0.0f) frac = 0.0f;
+    if (frac > 1.0f) frac = 1.0f;
+    return (row->direction < 0) ? -frac : frac;
+}
+
+float game_scroll_offset(const GameState *state, float alpha)
+{
+    if (!state || state->game_over || state->renascendo) return 0.0f;
+
+    float frac = ((float)state->scroll_timer + alpha) / (float)SCROLL_TICKS;
+    if (frac < 0.0f) frac = 0.0f;
+    if (frac > 1.0f) frac = 1.0f;
+    return frac;
+}
+
 /* -------------------------------------------------------
    INPUT / CONTROLES
    - Player livre (sem ancoragem/câmera).
@@ -2,6 +2,7 @@
 #define GAME_H
 
 #include "lista.h"
+#include <stdint.h>
 
 // Map configuration
 #define MAP_WIDTH  28  // Reduzido de 31 para 28 para caber na tela (28*25 + 50*2 = 800px)
@@ -9,6 +10,11 @@
 // PLAYER_ROW não é usado no modelo atual de scroll livre, mas pode ficar
 #define PLAYER_ROW (MAP_HEIGHT - 1)
 
+// Simulação em passo fixo: game_update avança exatamente 1 tick de 1/GAME_TICK_HZ segundos
+#define GAME_TICK_HZ 60
+// Mapa desce sozinho a cada SCROLL_TICKS ticks (ajuste a velocidade do scroll vertical)
+#define SCROLL_TICKS 120
+
 // Symbols
 #define CHAR_PLAYER 'O'
 #define CHAR_CAR    '='
@@ -50,6 +56,7 @@ typedef struct Player {
 
 typedef struct GameState {
     Row rows[MAP_HEIGHT];
+    Row incoming;         // próxima linha do topo: já gerada (e andando), entra no próximo scroll
     int player_x;  
     int player_y;  
     int score;    
@@ -57,6 +64,7 @@ typedef struct GameState {
 
     int world_position;   
     int just_scrolled;    
+    int scroll_timer;     // ticks desde o último scroll (0..SCROLL_TICKS-1)
 
     int world_head;       // Quantas linhas já nasceram no topo (quantos scrolls)
     int min_abs_reached;  // Menor índice absoluto já alcançado (melhor progresso)
@@ -72,14 +80,88 @@ typedef struct GameState {
     // === 2 PLAYER MODE ===
     Player p1, p2;              // Estruturas dos jogadores (P1 e P2)
     int two_players;            // Flag: 1 = modo 2 jogadores ativo, 0 = modo 1 jogador
+
+    // Aleatório da partida (mesma semente + mesmas entradas = mesma partida)
+    unsigned int seed;          // semente usada no game_init
+    unsigned int rng;           // estado atual do gerador (xorshift32)
 } GameState;
 
 void game_init(GameState *state, int width);
+
+// Igual a game_init, mas com semente fixa: o mundo gerado só depende dela
+void game_init_seeded(GameState *state, int width, unsigned int seed);
+
+// Semente nova a partir do relógio (é o que game_init usa)
+unsigned int game_make_seed(void);
+
+// Semente do dia (UTC): igual para todas as partidas do mesmo dia, base do desafio com fantasma
+unsigned int game_daily_seed(void);
 void game_reset(GameState *state);
 void game_update(GameState *state);
 void game_render(const GameState *state);
 void game_handle_input(GameState *state, int key);
 
+// Libera as filas de todas as linhas (o estado pode ser reinicializado com game_init depois)
+void game_destroy(GameState *state);
+
+/**
+ * Copia o estado completo de src para dst (snapshot)
+ * dst mantém filas próprias: são criadas na primeira cópia e reaproveitadas nas seguintes,
+ * então uma cópia em regime não aloca memória. dst deve começar zerado ou vir de uma cópia anterior.
+ * @return 1 se copiou tudo, 0 se faltou memória para alguma linha
+ */
+int game_copy_state(GameState *dst, const GameState *src);
+
+/* -------------------------------------------------------
+   HASH DE DETERMINISMO
+   - Um hash por grupo de campos: quando dois builds divergem,
+     dá para saber o tick e também o que divergiu.
+   - Não é incremental: cada chamada recalcula tudo (~600 bytes,
+     ~1.5 us). Só o headless chama, por tick; um hash guardado por
+     linha deixaria passar justo a escrita fora do lugar que o
+     hash existe para pegar.
+ ------------------------------------------------------- */
+typedef enum GameHashField {
+    GAME_HASH_LANES = 0,    // tipo, direção, velocidade e células de cada linha
+    GAME_HASH_PHASES,       // tick_counter/moved_this_tick das linhas, scroll_timer, just_scrolled
+    GAME_HASH_PLAYERS,      // posições, pontuação e progresso (P1/P2 inclusos), game_over
+    GAME_HASH_LIVES,        // vidas, renascimento e poder de vida
+    GAME_HASH_RNG,          // estado do gerador aleatório
+    GAME_HASH_WORLD,        // world_position, world_head
+    GAME_HASH_FIELD_COUNT
+} GameHashField;
+
+typedef struct GameHash {
+    uint32_t fields[GAME_HASH_FIELD_COUNT];
+    uint64_t total;         // combinação de todos os campos
+} GameHash;
+
+/**
+ * Calcula o hash do estado do zero (FNV-1a, percorre cada fila uma vez)
+ * @param state Estado do jogo
+ * @param out Hash por campo e total
+ */
+void game_hash(const GameState *state, GameHash *out);
+
+// Nome curto do campo ("lanes", "phases", ...)
+const char *game_hash_field_name(GameHashField field);
+
+/**
+ * Deslocamento horizontal interpolado de uma linha, em células
+ * Usa tick_counter/speed_ticks mais a fração do próximo tick para suavizar a rotação
+ * @param row Linha do mapa
+ * @param alpha Fração do tick atual já decorrida (0..1)
+ * @return Deslocamento em células (negativo = esquerda, positivo = direita)
+ */
+float game_row_offset(const Row *row, float alpha);
+
+/**
+ * Deslocamento vertical interpolado do mundo, em linhas (0..1)
+ * @param state Estado do jogo
+ * @param alpha Fração do tick atual já decorrida (0..1)
+ */
+float game_scroll_offset(const GameState *state, float alpha);
+
 // === 2 PLAYER MODE ===
 /**
  * Ativa ou desativa o modo 2 jogadores
@@ -0,0 +1,186 @@
+#include "ghost.h"
+#include "utils.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char GHOST_MAGIC[4] = { 'C', 'R', 'G', 'H' };
+static const char GHOST_KEYS[4] = { 'W', 'A', 'S', 'D' };
+
+/* -------------------------------------------------------
+   GRAVAÇÃO
+ ------------------------------------------------------- */
+static int key_code(char key)
+{
+    for (int i = 0; i < 4; ++i) {
+        if (GHOST_KEYS[i] == key) return i;
+    }
+    return -1;
+}
+
+void ghost_recorder_reset(GhostRecorder *rec)
+{
+    if (!rec) return;
+    rec->length = 0;
+    rec->last_tick = 0;
+    rec->overflow = 0;
+}
+
+void ghost_record(GhostRecorder *rec, unsigned tick, char key)
+{
+    int code = key_code(key);
+    if (!rec || rec->overflow || code < 0) return;
+
+    // Varint de (delta << 2 | tecla): 1 byte enquanto as teclas vêm a menos de 32 ticks
+    uint32_t v = ((uint32_t)(tick - rec->last_tick) << 2) | (uint32_t)code;
+    unsigned char buf[5];
+    int n = 0;
+    while (v >= 0x80) {
+        buf[n++] = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    buf[n++] = (unsigned char)v;
+
+    if (rec->length + n > GHOST_MAX_BYTES) {
+        rec->overflow = 1;
+        return;
+    }
+    memcpy(rec->data + rec->length, buf, (size_t)n);
+    rec->length += n;
+    rec->last_tick = tick;
+}
+
+int ghost_run_from_recorder(GhostRun *run, const GhostRecorder *rec, uint32_t seed, int score,
+                            uint32_t ticks, const char *name)
+{
+    if (!run || !rec || rec->overflow) return 0;
+    run->seed = seed;
+    run->score = score;
+    run->ticks = ticks;
+    strncpy(run->name, name ? name : "Player", MAX_NAME_LEN);
+    run->name[MAX_NAME_LEN] = '\0';
+    run->length = rec->length;
+    memcpy(run->data, rec->data, (size_t)rec->length);
+    return 1;
+}
+
+/* -------------------------------------------------------
+   REPRODUÇÃO (decodifica uma entrada por vez)
+ ------------------------------------------------------- */
+static void decode_next(GhostPlayer *player, unsigned base_tick)
+{
+    const GhostRun *run = player->run;
+    uint32_t v = 0;
+    int shift = 0;
+
+    player->next_key = 0;
+    while (player->pos < run->length && shift < 35) {
+        unsigned char b = run->data[player->pos++];
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            player->next_tick = base_tick + (v >> 2);
+            player->next_key = GHOST_KEYS[v & 3];
+            return;
+        }
+        shift += 7;
+    }
+}
+
+void ghost_player_start(GhostPlayer *player, const GhostRun *run)
+{
+    if (!player) return;
+    player->run = run;
+    player->pos = 0;
+    player->next_tick = 0;
+    player->next_key = 0;
+    if (run) decode_next(player, 0);
+}
+
+int ghost_player_next(GhostPlayer *player, unsigned tick, char *key)
+{
+    if (!player || !player->run || !player->next_key || player->next_tick > tick) return 0;
+    if (key) *key = player->next_key;
+    decode_next(player, tick);
+    return 1;
+}
+
+/* -------------------------------------------------------
+   ARQUIVO
+ ------------------------------------------------------- */
+void ghost_path(char *out, int size, const char *ranking_file, uint32_t seed)
+{
+    if (!out || size <= 0) return;
+    // Mesma pasta do ranking: corta o nome do arquivo depois da última barra
+    int dir_len = 0;
+    if (ranking_file) {
+        for (int i = 0; ranking_file[i]; ++i) {
+            if (ranking_file[i] == '/' || ranking_file[i] == '\\') dir_len = i + 1;
+        }
+    }
+    snprintf(out, (size_t)size, "%.*sghost_%08x.bin", dir_len, ranking_file ? ranking_file : "", (unsigned)seed);
+}
+
+static int put_u32(FILE *f, uint32_t v)
+{
+    unsigned char b[4] = { (unsigned char)v, (unsigned char)(v >> 8),
+                           (unsigned char)(v >> 16), (unsigned char)(v >> 24) };
+    return fwrite(b, 1, 4, f) == 4;
+}
+
+static int get_u32(FILE *f, uint32_t *v)
+{
+    unsigned char b[4];
+    if (fread(b, 1, 4, f) != 4) return 0;
+    *v = (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+    return 1;
+}
+
+int ghost_save(const char *path, const GhostRun *run)
+{
+    if (!path || !run) return 0;
+    // Temporário + troca: cair no meio da gravação não estraga o fantasma anterior
+    char tmp[GHOST_PATH_LEN + 8];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *f = fopen(tmp, "wb");
+    if (!f) return 0;
+    int ok = fwrite(GHOST_MAGIC, 1, 4, f) == 4 &&
+             put_u32(f, GHOST_VERSION) &&
+             put_u32(f, run->seed) &&
+             put_u32(f, (uint32_t)run->score) &&
+             put_u32(f, run->ticks) &&
+             put_u32(f, (uint32_t)run->length) &&
+             fwrite(run->name, 1, sizeof(run->name), f) == sizeof(run->name) &&
+             fwrite(run->data, 1, (size_t)run->length, f) == (size_t)run->length;
+    if (ok) ok = utils_fsync_file(f);
+    if (fclose(f) != 0) ok = 0;
+    if (ok) ok = utils_replace_file(tmp, path);
+    if (!ok) remove(tmp);
+    return ok;
+}
+
+int ghost_load(const char *path, GhostRun *run)
+{
+    if (!path || !run) return 0;
+    FILE *f = fopen(path, "rb");
+    if (!f) return 0;
+
+    char magic[4];
+    uint32_t version, score, length;
+    int ok = fread(magic, 1, 4, f) == 4 && memcmp(magic, GHOST_MAGIC, 4) == 0 &&
+             get_u32(f, &version) && version == GHOST_VERSION &&
+             get_u32(f, &run->seed) &&
+             get_u32(f, &score) &&
+             get_u32(f, &run->ticks) &&
+             get_u32(f, &length) && length <= GHOST_MAX_BYTES &&
+             fread(run->name, 1, sizeof(run->name), f) == sizeof(run->name) &&
+             fread(run->data, 1, length, f) == length;
+    fclose(f);
+
+    if (!ok) {
+        run->length = 0;
+        return 0;
+    }
+    run->score = (int)score;
+    run->length = (int)length;
+    run->name[MAX_NAME_LEN] = '\0';
+    return 1;
+}
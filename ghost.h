@@ -0,0 +1,77 @@
+#ifndef GHOST_H
+#define GHOST_H
+
+#include "ranking.h"
+#include <stdint.h>
+
+// Fantasma: a melhor partida de uma semente, guardada só como as entradas do jogador.
+// Com a mesma semente a partida é determinística, então o fantasma é reconstruído
+// re-simulando essas entradas num segundo GameState, tick a tick, ao lado do jogo.
+//
+// Arquivo (ghost_XXXXXXXX.bin ao lado do ranking, um por semente):
+//   "CRGH", versão, semente, pontuação, ticks, bytes de entradas (uint32 little-endian),
+//   nome (MAX_NAME_LEN + 1 bytes) e as entradas.
+// Cada entrada é um varint: (ticks desde a anterior << 2) | tecla (W, A, S, D = 0..3).
+// Uma partida de 10 minutos com 3 teclas/s cabe em uns 3 KB.
+
+#define GHOST_VERSION 2         // 2: o mundo gera a linha de cima um scroll antes (fantasmas da 1 não batem mais)
+#define GHOST_MAX_BYTES (16 * 1024)
+#define GHOST_PATH_LEN 512
+
+// Partida gravada (carregada inteira: o decodificador só anda um cursor sobre bytes)
+typedef struct GhostRun {
+    uint32_t seed;
+    int score;
+    uint32_t ticks;                 // duração da partida
+    char name[MAX_NAME_LEN + 1];
+    int length;                     // bytes usados em data
+    unsigned char data[GHOST_MAX_BYTES];
+} GhostRun;
+
+// Gravação durante a partida (buffer fixo, nada é alocado por tecla)
+typedef struct GhostRecorder {
+    unsigned char data[GHOST_MAX_BYTES];
+    int length;
+    unsigned last_tick;
+    int overflow;                   // 1 = passou de GHOST_MAX_BYTES, a gravação não vale
+} GhostRecorder;
+
+// Leitura em fluxo de um GhostRun
+typedef struct GhostPlayer {
+    const GhostRun *run;
+    int pos;                        // próximo byte de run->data
+    unsigned next_tick;             // tick da próxima entrada
+    char next_key;                  // 0 = acabaram as entradas
+} GhostPlayer;
+
+void ghost_recorder_reset(GhostRecorder *rec);
+
+// Grava uma tecla aplicada no tick (ticks em ordem não decrescente)
+void ghost_record(GhostRecorder *rec, unsigned tick, char key);
+
+/**
+ * Monta a partida gravada para salvar
+ * @return 0 se a gravação estourou o buffer
+ */
+int ghost_run_from_recorder(GhostRun *run, const GhostRecorder *rec, uint32_t seed, int score,
+                            uint32_t ticks, const char *name);
+
+void ghost_player_start(GhostPlayer *player, const GhostRun *run);
+
+/**
+ * Próxima tecla do fantasma aplicada no tick
+ * Chamar em loop até retornar 0, uma vez por tick, com ticks crescentes
+ */
+int ghost_player_next(GhostPlayer *player, unsigned tick, char *key);
+
+/**
+ * Caminho do arquivo do fantasma da semente, na mesma pasta do ranking
+ * @param ranking_file Caminho do ranking (ex.: "ranking.txt")
+ */
+void ghost_path(char *out, int size, const char *ranking_file, uint32_t seed);
+
+// Retornam 1 em sucesso
+int ghost_save(const char *path, const GhostRun *run);
+int ghost_load(const char *path, GhostRun *run);
+
+#endif // GHOST_H
@@ -0,0 +1,81 @@
+// Compara dois fluxos de hash (headless --hash-out) e aponta o primeiro tick divergente.
+// Uso: hashcmp a.hash b.hash
+// Código de saída: 0 = idênticos, 1 = divergem, 2 = erro de leitura
+
+#include "hashstream.h"
+#include <stdio.h>
+
+static FILE *open_stream(const char *path, uint32_t *seed, int *field_count)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "hashcmp: nao abriu %s\n", path);
+        return NULL;
+    }
+    if (!hashstream_read_header(f, seed, field_count)) {
+        fprintf(stderr, "hashcmp: %s nao e um fluxo de hash valido\n", path);
+        fclose(f);
+        return NULL;
+    }
+    return f;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 3) {
+        fprintf(stderr, "uso: %s a.hash b.hash\n", argv[0]);
+        return 2;
+    }
+
+    uint32_t seed_a, seed_b;
+    int fields_a, fields_b;
+    FILE *a = open_stream(argv[1], &seed_a, &fields_a);
+    FILE *b = a ? open_stream(argv[2], &seed_b, &fields_b) : NULL;
+    if (!a || !b) {
+        if (a) fclose(a);
+        return 2;
+    }
+
+    if (seed_a != seed_b) printf("aviso: sementes diferentes (%u x %u)\n", seed_a, seed_b);
+    if (fields_a != fields_b) printf("aviso: numero de campos diferente (%d x %d)\n", fields_a, fields_b);
+    int common = fields_a < fields_b ? fields_a : fields_b;
+    if (common > GAME_HASH_FIELD_COUNT) common = GAME_HASH_FIELD_COUNT;
+
+    HashRecord ra, rb;
+    long records = 0;
+    int result = 0;
+    while (1) {
+        int has_a = hashstream_read(a, fields_a, &ra);
+        int has_b = hashstream_read(b, fields_b, &rb);
+        if (!has_a || !has_b) {
+            if (has_a != has_b) {
+                printf("%s termina antes, depois de %ld ticks\n", has_a ? argv[2] : argv[1], records);
+                result = 1;
+            }
+            break;
+        }
+        if (ra.tick != rb.tick) {
+            printf("registro %ld: ticks fora de ordem (%u x %u)\n", records, ra.tick, rb.tick);
+            result = 1;
+            break;
+        }
+
+        int diverged = 0;
+        for (int i = 0; i < common; ++i) {
+            if (ra.fields[i] == rb.fields[i]) continue;
+            if (!diverged) printf("primeira divergencia no tick %u:\n", ra.tick);
+            printf("  %-8s %08x x %08x\n", game_hash_field_name((GameHashField)i), ra.fields[i], rb.fields[i]);
+            diverged = 1;
+        }
+        if (diverged) {
+            result = 1;
+            break;
+        }
+        records++;
+    }
+
+    if (result == 0) printf("identicos: %ld ticks\n", records);
+    fclose(a);
+    fclose(b);
+    return result;
+}
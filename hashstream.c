@@ -0,0 +1,63 @@
+#include "hashstream.h"
+#include <string.h>
+
+static const char HASHSTREAM_MAGIC[4] = { 'C', 'R', 'H', 'S' };
+
+static int put_u32(FILE *f, uint32_t v)
+{
+    unsigned char b[4] = { (unsigned char)v, (unsigned char)(v >> 8),
+                           (unsigned char)(v >> 16), (unsigned char)(v >> 24) };
+    return fwrite(b, 1, 4, f) == 4;
+}
+
+static int get_u32(FILE *f, uint32_t *v)
+{
+    unsigned char b[4];
+    if (fread(b, 1, 4, f) != 4) return 0;
+    *v = (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+    return 1;
+}
+
+int hashstream_write_header(FILE *f, uint32_t seed)
+{
+    if (!f) return 0;
+    return fwrite(HASHSTREAM_MAGIC, 1, 4, f) == 4 &&
+           put_u32(f, HASHSTREAM_VERSION) &&
+           put_u32(f, seed) &&
+           put_u32(f, GAME_HASH_FIELD_COUNT);
+}
+
+int hashstream_write(FILE *f, uint32_t tick, const GameHash *hash)
+{
+    if (!f || !hash) return 0;
+    if (!put_u32(f, tick)) return 0;
+    for (int i = 0; i < GAME_HASH_FIELD_COUNT; ++i) {
+        if (!put_u32(f, hash->fields[i])) return 0;
+    }
+    return 1;
+}
+
+int hashstream_read_header(FILE *f, uint32_t *seed, int *field_count)
+{
+    char magic[4];
+    uint32_t version, s, count;
+    if (!f || fread(magic, 1, 4, f) != 4 || memcmp(magic, HASHSTREAM_MAGIC, 4) != 0) return 0;
+    if (!get_u32(f, &version) || version != HASHSTREAM_VERSION) return 0;
+    if (!get_u32(f, &s) || !get_u32(f, &count) || count == 0 || count > 64) return 0;
+    if (seed) *seed = s;
+    if (field_count) *field_count = (int)count;
+    return 1;
+}
+
+int hashstream_read(FILE *f, int field_count, HashRecord *rec)
+{
+    if (!f || !rec) return 0;
+    memset(rec, 0, sizeof(*rec));
+    if (!get_u32(f, &rec->tick)) return 0;
+    for (int i = 0; i < field_count; ++i) {
+        uint32_t v;
+        if (!get_u32(f, &v)) return 0;
+        if (i < GAME_HASH_FIELD_COUNT) rec->fields[i] = v;
+    }
+    return 1;
+}
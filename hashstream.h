@@ -0,0 +1,33 @@
+#ifndef HASHSTREAM_H
+#define HASHSTREAM_H
+
+#include "game.h"
+#include <stdio.h>
+#include <stdint.h>
+
+// Fluxo binário de hashes por tick (para comparar builds/máquinas).
+// Cabeçalho: "CRHS", versão, semente, número de campos (uint32 little-endian).
+// Registro:  tick + um uint32 por campo de GameHash (28 bytes com 6 campos).
+
+#define HASHSTREAM_VERSION 1
+
+typedef struct HashRecord {
+    uint32_t tick;
+    uint32_t fields[GAME_HASH_FIELD_COUNT];
+} HashRecord;
+
+// Retornam 1 em sucesso, 0 em erro de escrita
+int hashstream_write_header(FILE *f, uint32_t seed);
+int hashstream_write(FILE *f, uint32_t tick, const GameHash *hash);
+
+/**
+ * Lê e valida o cabeçalho
+ * @param field_count Campos por registro no arquivo (pode ser diferente deste build)
+ * @return 1 se o arquivo é um fluxo válido
+ */
+int hashstream_read_header(FILE *f, uint32_t *seed, int *field_count);
+
+// Lê o próximo registro. Campos além de GAME_HASH_FIELD_COUNT são ignorados. 0 = fim do arquivo
+int hashstream_read(FILE *f, int field_count, HashRecord *rec);
+
+#endif // HASHSTREAM_H
@@ -0,0 +1,675 @@
+// Driver sem janela: roda game_update direto (sem raylib e sem a thread da simulação),
+// o mais rápido possível, com um bot simples jogando. Partidas emendam uma na outra.
+// Serve para medir a lógica isolada: contadores de alocação por subsistema e modo soak.
+//
+// Uso: headless [--ticks N] [--report N] [--two] [--seed N] [--hash-out ARQ]
+//   --ticks N       ticks simulados no total (padrão 36000 = 10 min de jogo)
+//   --report N      imprime os contadores a cada N ticks (padrão 3600)
+//   --two           modo 2 jogadores
+//   --seed N        semente fixa: mundo, bot e partidas seguintes ficam reproduzíveis
+//   --hash-out ARQ  grava o hash do estado a cada tick (comparar com hashcmp)
+//   --watch K       mostra a partida no terminal rodando K ticks por frame (60 frames/s);
+//                   "--watch max" simula o máximo que couber em cada frame
+//
+// Soak (horas/dias de partidas seguidas): headless --soak SEGUNDOS [opções]
+//   --sample S             intervalo entre amostras, em segundos (padrão 10)
+//   --warmup S             tempo antes da amostra de referência (padrão 10% do soak, no mínimo 30)
+//   --max-rss-growth KB    crescimento de RSS tolerado sobre a referência (padrão 1024)
+//   --max-alloc-growth N   crescimento de blocos vivos tolerado (padrão 0)
+//   --max-p99-drift X      p99 do tick pode chegar a X vezes o da referência (padrão 3.0;
+//                          abaixo de SOAK_P99_FLOOR_US não conta, é ruído do relógio)
+// Falha (código 1) se algum limite estourar.
+//
+// Rewind (modo prática): headless --rewind S [--ticks N]
+//   Grava checkpoints como o modo prática (S segundos de histórico), volta no tempo de
+//   tempos em tempos e confere o hash do estado restaurado com o gravado naquele tick.
+//   Mostra custo do checkpoint, tempo de restauração e bytes por minuto de histórico.
+//   Falha (código 1) se algum estado restaurado divergir.
+//
+// Carregador do ranking: headless --ranking-bench N
+//   Gera um ranking.txt de N linhas (com algumas linhas ruins) e mede o carregador
+//   (arquivo mapeado + scanner) contra fgets + sscanf por linha fazendo o mesmo trabalho.
+//   Falha (código 1) se os dois montarem rankings diferentes ou se as linhas ruins não
+//   forem todas relatadas.
+
+#include "game.h"
+#include "hashstream.h"
+#include "mem.h"
+#include "ranking.h"
+#include "rewind.h"
+#include "utils.h"
+#include "trace.h"
+#include "term_view.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct HeadlessOptions {
+    long ticks;
+    long report_every;
+    int two_players;
+    unsigned int seed;
+    const char *hash_out;
+    int watch;                  // 0 = sem tela; K ticks por frame; WATCH_UNBOUNDED = sem limite
+
+    // Soak
+    double soak_seconds;        // 0 = modo normal (por ticks)
+    double sample_seconds;
+    double warmup_seconds;      // < 0 = 10% da duração (mínimo 30 s)
+    long long max_rss_growth_kb;
+    long long max_alloc_growth;
+    double max_p99_drift;
+
+    int rewind_seconds;         // 0 = sem verificação do rewind
+    long ranking_bench_lines;   // 0 = sem benchmark do carregador do ranking
+} HeadlessOptions;
+
+/* -------------------------------------------------------
+   BOT
+   - A cada BOT_STEP_TICKS olha a célula à frente: sobe se for
+     segura, senão anda para o lado (ou espera).
+   - Tem gerador próprio (derivado de --seed) para a sessão
+     inteira ser reproduzível, inclusive as sementes das
+     partidas seguintes.
+ ------------------------------------------------------- */
+#define BOT_STEP_TICKS 8
+#define WATCH_UNBOUNDED (-1)
+
+static unsigned int bot_rng = 1;
+
+// Se não for NULL, as teclas do bot são gravadas aqui (como sim_drain_inputs faz na prática)
+static RewindBuffer *bot_record = NULL;
+static unsigned bot_record_tick = 0;
+
+static int bot_random_int(int min_value, int max_value)
+{
+    bot_rng ^= bot_rng << 13;
+    bot_rng ^= bot_rng >> 17;
+    bot_rng ^= bot_rng << 5;
+    return min_value + (int)(bot_rng % (unsigned int)(max_value - min_value + 1));
+}
+
+static int cell_is_safe(const GameState *state, int x, int y)
+{
+    if (y < 0 || y >= MAP_HEIGHT || x < 0 || x >= MAP_WIDTH) return 0;
+    const Row *row = &state->rows[y];
+    char cell = queue_get_cell(row->queue, x);
+    if (row->type == ROW_ROAD) return cell != CHAR_CAR;
+    if (row->type == ROW_RIVER) return cell == CHAR_LOG;
+    return 1;
+}
+
+static char bot_choose_key(const GameState *state, int x, int y)
+{
+    if (cell_is_safe(state, x, y - 1)) return 'W';
+    int side = bot_random_int(0, 2);
+    if (side == 0 && cell_is_safe(state, x - 1, y)) return 'A';
+    if (side == 1 && cell_is_safe(state, x + 1, y)) return 'D';
+    return 0;
+}
+
+static void bot_press(GameState *state, int player_id, char key)
+{
+    if (bot_record) rewind_record_input(bot_record, bot_record_tick, player_id, key);
+    if (player_id == 0) game_handle_input(state, key);
+    else                game_handle_input_player(state, player_id, key);
+}
+
+static void bot_step(GameState *state)
+{
+    if (state->renascendo) return;
+    if (state->two_players) {
+        for (int id = 1; id <= 2; ++id) {
+            if (!game_is_player_alive(state, id)) continue;
+            int x, y;
+            game_get_player_pos(state, id, &x, &y);
+            char key = bot_choose_key(state, x, y);
+            if (key) bot_press(state, id, key);
+        }
+    } else {
+        char key = bot_choose_key(state, state->player_x, state->player_y);
+        if (key) bot_press(state, 0, key);
+    }
+}
+
+// Um tick completo do driver: bot, lógica e recomeço automático no game over
+static void headless_tick(GameState *state, long tick, const HeadlessOptions *opt, long *sessions)
+{
+    if (tick % BOT_STEP_TICKS == 0) bot_step(state);
+    game_update(state);
+
+    if (state->game_over) {
+        // Mesmo caminho do game_reset, mas com semente vinda do bot
+        game_destroy(state);
+        game_init_seeded(state, MAP_WIDTH, (unsigned int)bot_random_int(1, 0x7FFFFFFF));
+        if (opt->two_players) game_set_two_players(state, 1);
+        (*sessions)++;
+    }
+}
+
+/* -------------------------------------------------------
+   RELATÓRIO
+ ------------------------------------------------------- */
+static void print_mem_header(void)
+{
+    printf("%10s %8s  %-8s %12s %12s %10s %12s\n",
+           "tick", "partidas", "tag", "vivos(B)", "pico(B)", "blocos", "aloc/tick");
+}
+
+static void print_mem_report(long tick, long sessions, MemReport *report, long long prev_totals[MEM_TAG_COUNT],
+                             long ticks_since)
+{
+    mem_report(report);
+    for (int i = 0; i < MEM_TAG_COUNT; ++i) {
+        const MemTagStats *t = &report->tags[i];
+        double per_tick = ticks_since > 0 ? (double)(t->total_allocs - prev_totals[i]) / ticks_since : 0.0;
+        printf("%10ld %8ld  %-8s %12lld %12lld %10lld %12.2f\n",
+               tick, sessions, mem_tag_name((MemTag)i), t->live_bytes, t->peak_bytes, t->live_allocs, per_tick);
+        prev_totals[i] = t->total_allocs;
+    }
+}
+
+static int parse_options(int argc, char **argv, HeadlessOptions *opt)
+{
+    opt->ticks = 36000;
+    opt->report_every = 3600;
+    opt->two_players = 0;
+    opt->seed = game_make_seed();
+    opt->hash_out = NULL;
+    opt->watch = 0;
+    opt->soak_seconds = 0.0;
+    opt->sample_seconds = 10.0;
+    opt->warmup_seconds = -1.0;
+    opt->max_rss_growth_kb = 1024;
+    opt->max_alloc_growth = 0;
+    opt->max_p99_drift = 3.0;
+    opt->rewind_seconds = 0;
+    opt->ranking_bench_lines = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            opt->ticks = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+            opt->report_every = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--two") == 0) {
+            opt->two_players = 1;
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            opt->seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--hash-out") == 0 && i + 1 < argc) {
+            opt->hash_out = argv[++i];
+        } else if (strcmp(argv[i], "--watch") == 0 && i + 1 < argc) {
+            ++i;
+            opt->watch = (strcmp(argv[i], "max") == 0) ? WATCH_UNBOUNDED : atoi(argv[i]);
+            if (opt->watch == 0) opt->watch = 1;
+        } else if (strcmp(argv[i], "--soak") == 0 && i + 1 < argc) {
+            opt->soak_seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--sample") == 0 && i + 1 < argc) {
+            opt->sample_seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            opt->warmup_seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--max-rss-growth") == 0 && i + 1 < argc) {
+            opt->max_rss_growth_kb = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--max-alloc-growth") == 0 && i + 1 < argc) {
+            opt->max_alloc_growth = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--max-p99-drift") == 0 && i + 1 < argc) {
+            opt->max_p99_drift = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--rewind") == 0 && i + 1 < argc) {
+            opt->rewind_seconds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--ranking-bench") == 0 && i + 1 < argc) {
+            opt->ranking_bench_lines = atol(argv[++i]);
+        } else {
+            fprintf(stderr, "uso: %s [--ticks N] [--report N] [--two] [--seed N] [--hash-out ARQ] [--watch K|max] [--soak S [--sample S] [--warmup S] "
+                            "[--max-rss-growth KB] [--max-alloc-growth N] [--max-p99-drift X]] [--rewind S] [--ranking-bench N]\n", argv[0]);
+            return 0;
+        }
+    }
+    if (opt->report_every <= 0) opt->report_every = opt->ticks;
+    if (opt->sample_seconds <= 0.0) opt->sample_seconds = 10.0;
+    if (opt->warmup_seconds < 0.0) {
+        // O heap leva alguns segundos de churn até o RSS estabilizar
+        opt->warmup_seconds = opt->soak_seconds * 0.1;
+        if (opt->warmup_seconds < 30.0) opt->warmup_seconds = 30.0;
+    }
+    return 1;
+}
+
+/* -------------------------------------------------------
+   WATCH (TURBO)
+   - Um frame a cada 1/60 s com K ticks antes de cada um: a
+     partida passa a Kx e o render é dizimado (1 a cada K ticks).
+   - Sem limite: simula até 3/4 do orçamento do frame e desenha.
+   - O rodapé mostra ticks/s alcançados e quanto do frame foi
+     lógica x render, para ver quem vira o gargalo.
+ ------------------------------------------------------- */
+#define WATCH_FPS 60
+
+static void run_watch(GameState *state, const HeadlessOptions *opt)
+{
+    const double frame_dt = 1.0 / WATCH_FPS;
+    long tick = 0, sessions = 1, frames = 0;
+    long window_ticks = 0;
+    double window_start = utils_now_seconds(), tps = 0.0;
+    double sim_time = 0.0, render_time = 0.0;
+
+    utils_write_stdout("\033[?25l", 6);   // esconde o cursor
+    term_view_reset();
+    double start = utils_now_seconds();
+
+    while (tick < opt->ticks) {
+        double frame_start = utils_now_seconds();
+
+        if (opt->watch == WATCH_UNBOUNDED) {
+            double budget_end = frame_start + frame_dt * 0.75;
+            while (tick < opt->ticks) {
+                headless_tick(state, ++tick, opt, &sessions);
+                window_ticks++;
+                // Confere o relógio só a cada 64 ticks: ler o relógio custa mais que um tick
+                if ((tick & 63) == 0 && utils_now_seconds() >= budget_end) break;
+            }
+        } else {
+            for (int k = 0; k < opt->watch && tick < opt->ticks; ++k) {
+                headless_tick(state, ++tick, opt, &sessions);
+                window_ticks++;
+            }
+        }
+        double sim_end = utils_now_seconds();
+
+        game_render(state);
+        double render_end = utils_now_seconds();
+        sim_time += sim_end - frame_start;
+        render_time += render_end - sim_end;
+        frames++;
+
+        if (render_end - window_start >= 0.5) {
+            tps = window_ticks / (render_end - window_start);
+            window_ticks = 0;
+            window_start = render_end;
+        }
+        char status[128];
+        snprintf(status, sizeof(status), "%.0f ticks/s (%.0fx)  tick %ld  partida %ld  logica %.2f ms/frame  render %.2f ms/frame",
+                 tps, tps / GAME_TICK_HZ, tick, sessions, sim_time * 1000.0 / frames, render_time * 1000.0 / frames);
+        term_view_status(status);
+
+        double wait = frame_start + frame_dt - utils_now_seconds();
+        if (wait > 0.001) utils_sleep_ms((int)(wait * 1000.0));
+    }
+
+    double elapsed = utils_now_seconds() - start;
+    utils_write_stdout("\033[0m\033[?25h\n", 11);
+    printf("%ld ticks em %.2f s: %.0f ticks/s, %ld frames, logica %.2f ms/frame, render %.2f ms/frame\n",
+           tick, elapsed, elapsed > 0.0 ? tick / elapsed : 0.0, frames,
+           frames ? sim_time * 1000.0 / frames : 0.0, frames ? render_time * 1000.0 / frames : 0.0);
+}
+
+/* -------------------------------------------------------
+   SOAK
+   - Joga partidas seguidas até acabar o tempo de parede.
+   - A cada amostra: RSS, blocos vivos e percentis do tempo de tick.
+   - A 1a amostra depois do aquecimento é a referência (heap e
+     páginas já estabilizados); as seguintes não podem crescer
+     além dos limites.
+ ------------------------------------------------------- */
+#define SOAK_TICK_SAMPLES 65536     // últimos ticks usados nos percentis de cada amostra
+#define SOAK_P99_FLOOR_US 5.0       // p99 abaixo disso nunca é considerado deriva
+
+static double tick_times[SOAK_TICK_SAMPLES];    // segundos por tick (ring)
+static double sorted_times[SOAK_TICK_SAMPLES];
+
+typedef struct SoakSample {
+    long long rss_bytes;
+    long long live_allocs;
+    double p50_us, p99_us, max_us;
+} SoakSample;
+
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void soak_percentiles(int count, SoakSample *out)
+{
+    out->p50_us = out->p99_us = out->max_us = 0.0;
+    if (count <= 0) return;
+    memcpy(sorted_times, tick_times, (size_t)count * sizeof(double));
+    qsort(sorted_times, (size_t)count, sizeof(double), compare_double);
+    out->p50_us = sorted_times[count / 2] * 1e6;
+    out->p99_us = sorted_times[(count * 99) / 100] * 1e6;
+    out->max_us = sorted_times[count - 1] * 1e6;
+}
+
+static long long soak_live_allocs(void)
+{
+    MemReport report = {0};
+    mem_report(&report);
+    long long total = 0;
+    for (int i = 0; i < MEM_TAG_COUNT; ++i) total += report.tags[i].live_allocs;
+    return total;
+}
+
+// Confere uma amostra contra a referência; imprime o motivo de cada falha
+static int soak_check(const SoakSample *base, const SoakSample *cur, const HeadlessOptions *opt)
+{
+    int ok = 1;
+    if (base->rss_bytes >= 0 && cur->rss_bytes >= 0 &&
+        cur->rss_bytes - base->rss_bytes > opt->max_rss_growth_kb * 1024) {
+        printf("  FALHA: RSS cresceu %lld KB (limite %lld KB)\n",
+               (cur->rss_bytes - base->rss_bytes) / 1024, opt->max_rss_growth_kb);
+        ok = 0;
+    }
+    if (cur->live_allocs - base->live_allocs > opt->max_alloc_growth) {
+        printf("  FALHA: blocos vivos cresceram %lld (limite %lld)\n",
+               cur->live_allocs - base->live_allocs, opt->max_alloc_growth);
+        ok = 0;
+    }
+    if (cur->p99_us > SOAK_P99_FLOOR_US && cur->p99_us > base->p99_us * opt->max_p99_drift) {
+        printf("  FALHA: p99 do tick foi de %.2f para %.2f us (limite %.1fx)\n",
+               base->p99_us, cur->p99_us, opt->max_p99_drift);
+        ok = 0;
+    }
+    return ok;
+}
+
+static int run_soak(GameState *state, const HeadlessOptions *opt)
+{
+    printf("soak: %.0f s, amostra a cada %.0f s, referencia depois de %.0f s\n",
+           opt->soak_seconds, opt->sample_seconds, opt->warmup_seconds);
+    printf("%8s %10s %12s %8s %10s %10s %10s %10s\n",
+           "t(s)", "partidas", "ticks", "RSS(KB)", "blocos", "p50(us)", "p99(us)", "max(us)");
+
+    SoakSample base = {0};
+    int have_base = 0, ok = 1;
+    long sessions = 1, tick = 0;
+    int count = 0, pos = 0;
+
+    double start = utils_now_seconds();
+    double next_sample = start + opt->sample_seconds;
+    double end = start + opt->soak_seconds;
+
+    while (ok) {
+        double t0 = utils_now_seconds();
+        headless_tick(state, ++tick, opt, &sessions);
+        double t1 = utils_now_seconds();
+
+        tick_times[pos] = t1 - t0;
+        pos = (pos + 1) % SOAK_TICK_SAMPLES;
+        if (count < SOAK_TICK_SAMPLES) count++;
+
+        if (t1 < next_sample) continue;
+
+        SoakSample cur;
+        cur.rss_bytes = utils_rss_bytes();
+        cur.live_allocs = soak_live_allocs();
+        soak_percentiles(count, &cur);
+        count = pos = 0;
+
+        printf("%8.0f %10ld %12ld %8lld %10lld %10.2f %10.2f %10.2f\n",
+               t1 - start, sessions, tick, cur.rss_bytes >= 0 ? cur.rss_bytes / 1024 : -1,
+               cur.live_allocs, cur.p50_us, cur.p99_us, cur.max_us);
+        fflush(stdout);
+
+        if (!have_base) {
+            if (t1 - start >= opt->warmup_seconds) {
+                base = cur;
+                have_base = 1;
+            }
+        } else {
+            ok = soak_check(&base, &cur, opt);
+        }
+
+        if (t1 >= end) break;
+        next_sample += opt->sample_seconds;
+    }
+
+    printf("soak %s: %ld partidas, %ld ticks\n", ok ? "OK" : "FALHOU", sessions, tick);
+    return ok;
+}
+
+/* -------------------------------------------------------
+   REWIND
+   - Mesmo caminho do modo prática: entradas do bot gravadas
+     no tick em que são aplicadas, checkpoint após cada tick.
+   - A cada REWIND_CHECK_TICKS volta um trecho aleatório (até a
+     janela inteira) e compara o hash restaurado com o gravado
+     naquele tick. A partida segue do ponto restaurado.
+ ------------------------------------------------------- */
+#define REWIND_HASH_RING 65536     // potência de 2, maior que a janela em ticks
+#define REWIND_CHECK_TICKS 240
+
+static int run_rewind_check(GameState *state, const HeadlessOptions *opt)
+{
+    static RewindBuffer rb;
+    static uint64_t hashes[REWIND_HASH_RING];
+    if (!rewind_init(&rb, opt->rewind_seconds)) {
+        fprintf(stderr, "headless: sem memoria para o rewind\n");
+        return 0;
+    }
+
+    unsigned window = rb.max_ticks < REWIND_HASH_RING ? rb.max_ticks : REWIND_HASH_RING - 1;
+    unsigned game_tick = 0, since_check = 0;
+    long checks = 0, mismatches = 0;
+    double restore_ms_sum = 0.0, restore_ms_max = 0.0;
+    GameHash hash;
+
+    bot_record = &rb;
+    rewind_after_tick(&rb, state, 0);
+    game_hash(state, &hash);
+    hashes[0] = hash.total;
+
+    for (long tick = 1; tick <= opt->ticks; ++tick) {
+        bot_record_tick = ++game_tick;
+        if (game_tick % BOT_STEP_TICKS == 0) bot_step(state);
+        if (!state->game_over) game_update(state);
+        rewind_after_tick(&rb, state, game_tick);
+        game_hash(state, &hash);
+        hashes[game_tick & (REWIND_HASH_RING - 1)] = hash.total;
+
+        if (++since_check == REWIND_CHECK_TICKS) {
+            unsigned limit = game_tick < window ? game_tick : window;
+            unsigned back = (unsigned)bot_random_int(1, (int)limit);
+            since_check = 0;
+            unsigned target = game_tick - back;
+            if (rewind_to(&rb, state, &target)) {
+                game_hash(state, &hash);
+                if (hash.total != hashes[target & (REWIND_HASH_RING - 1)]) {
+                    mismatches++;
+                    printf("DIVERGIU: volta de %u para o tick %u\n", game_tick, target);
+                }
+                checks++;
+                restore_ms_sum += rb.last_restore_ms;
+                if (rb.last_restore_ms > restore_ms_max) restore_ms_max = rb.last_restore_ms;
+                game_tick = target;
+            }
+        }
+
+        if (state->game_over) {
+            game_destroy(state);
+            game_init_seeded(state, MAP_WIDTH, (unsigned int)bot_random_int(1, 0x7FFFFFFF));
+            if (opt->two_players) game_set_two_players(state, 1);
+            rewind_clear(&rb);
+            game_tick = 0;
+            rewind_after_tick(&rb, state, 0);
+            game_hash(state, &hash);
+            hashes[0] = hash.total;
+        }
+    }
+
+    RewindStats st;
+    rewind_stats(&rb, &st);
+    printf("rewind: %ld voltas, %ld divergencias\n", checks, mismatches);
+    printf("  checkpoint: %.2f us em media (1 a cada %d ticks)\n", st.checkpoint_us, REWIND_CHECKPOINT_TICKS);
+    printf("  restaurar: %.3f ms em media, %.3f ms no pior caso\n",
+           checks ? restore_ms_sum / checks : 0.0, restore_ms_max);
+    printf("  historico: %.1f s em %d bytes (%.1f KB/min)\n",
+           st.history_seconds, st.bytes_used, st.bytes_per_minute / 1024.0);
+
+    bot_record = NULL;
+    rewind_free(&rb);
+    return mismatches == 0;
+}
+
+/* -------------------------------------------------------
+   RANKING (CARREGADOR)
+   - Arquivo sintético: 500 nomes repetidos, pontuações
+     aleatórias, uma linha ruim a cada RANKING_BENCH_BAD_EVERY.
+   - Referência: fgets + sscanf por linha, como o carregador
+     anterior, com o mesmo trabalho por partida (ranking_add
+     só em memória: top-K, histograma e jogador).
+   - Melhor de RANKING_BENCH_RUNS execuções de cada um.
+ ------------------------------------------------------- */
+#define RANKING_BENCH_FILE "ranking_bench.txt"
+#define RANKING_BENCH_BAD_EVERY 10000
+#define RANKING_BENCH_RUNS 3
+
+static double bench_sscanf_load(Ranking *ranking, const char *path)
+{
+    double start = utils_now_seconds();
+    ranking_load(ranking, NULL);                // zera (sem arquivo)
+    FILE *f = fopen(path, "r");
+    if (!f) return 0.0;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        char name[128];
+        int score;
+        if (!strchr(line, '\n')) break;
+        if (sscanf(line, "%127[^;];%d", name, &score) == 2) ranking_add(ranking, RANKING_MODE_SOLO, 0, name, score, NULL);
+    }
+    fclose(f);
+    return (utils_now_seconds() - start) * 1000.0;
+}
+
+static int run_ranking_bench(const HeadlessOptions *opt)
+{
+    FILE *f = fopen(RANKING_BENCH_FILE, "w");
+    if (!f) {
+        fprintf(stderr, "headless: nao foi possivel gravar %s\n", RANKING_BENCH_FILE);
+        return 0;
+    }
+    long bad = 0;
+    for (long i = 1; i <= opt->ranking_bench_lines; ++i) {
+        if (i % RANKING_BENCH_BAD_EVERY == 0) {
+            fprintf(f, "linha sem pontuacao\n");
+            bad++;
+        } else {
+            fprintf(f, "jogador%03d;%d\n", bot_random_int(0, 499), bot_random_int(0, 3000));
+        }
+    }
+    long size = ftell(f);
+    fclose(f);
+
+    static Ranking reference, fast;
+    double ref_ms = 0.0, fast_ms = 0.0;
+    RankingLoadReport report;
+    for (int run = 0; run < RANKING_BENCH_RUNS; ++run) {
+        double ms = bench_sscanf_load(&reference, RANKING_BENCH_FILE);
+        if (run == 0 || ms < ref_ms) ref_ms = ms;
+        ranking_load(&fast, RANKING_BENCH_FILE);
+        ranking_load_report(&report);
+        if (run == 0 || report.ms < fast_ms) fast_ms = report.ms;
+    }
+    remove(RANKING_BENCH_FILE);
+
+    static ScoreEntry reference_top[MAX_SCORES], fast_top[MAX_SCORES];
+    int top_count = ranking_top(&fast, RANKING_MODE_SOLO, fast_top);
+    int same = ranking_top(&reference, RANKING_MODE_SOLO, reference_top) == top_count &&
+               ranking_total_runs(&reference, RANKING_MODE_ALL) == ranking_total_runs(&fast, RANKING_MODE_ALL);
+    for (int i = 0; same && i < top_count; ++i) {
+        same = reference_top[i].score == fast_top[i].score && strcmp(reference_top[i].name, fast_top[i].name) == 0;
+    }
+    printf("ranking: %ld linhas, %.1f MB\n", opt->ranking_bench_lines, size / (1024.0 * 1024.0));
+    printf("  fgets + sscanf: %.1f ms\n", ref_ms);
+    printf("  mapeado + scanner: %.1f ms (%.1fx, %.0f MB/s)\n", fast_ms, fast_ms > 0.0 ? ref_ms / fast_ms : 0.0,
+           fast_ms > 0.0 ? size / (1024.0 * 1024.0) / (fast_ms / 1000.0) : 0.0);
+    printf("  %u partidas, %u linhas ruins", report.loaded, report.malformed);
+    if (report.malformed > 0) printf(" (primeira: linha %u)", report.bad_lines[0]);
+    printf(", top-K %s\n", same ? "igual" : "DIFERENTE");
+    return same && report.malformed == (uint32_t)bad;
+}
+
+int main(int argc, char **argv)
+{
+    HeadlessOptions opt;
+    if (!parse_options(argc, argv, &opt)) return 2;
+
+    trace_start(getenv("CROSSY_TRACE"));
+
+    if (opt.ranking_bench_lines > 0) {
+        int ok = run_ranking_bench(&opt);
+        trace_stop();
+        return ok ? 0 : 1;
+    }
+
+    static GameState state;
+    game_init_seeded(&state, MAP_WIDTH, opt.seed);
+    if (opt.two_players) game_set_two_players(&state, 1);
+    bot_rng = opt.seed ? opt.seed : 1u;
+    printf("semente: %u\n", opt.seed);
+    fflush(stdout);             // o modo --watch escreve direto no terminal
+
+    if (opt.watch) {
+        run_watch(&state, &opt);
+        game_destroy(&state);
+        trace_stop();
+        return 0;
+    }
+
+    if (opt.soak_seconds > 0.0) {
+        int ok = run_soak(&state, &opt);
+        game_destroy(&state);
+        trace_stop();
+        return ok ? 0 : 1;
+    }
+
+    if (opt.rewind_seconds > 0) {
+        int ok = run_rewind_check(&state, &opt);
+        game_destroy(&state);
+        trace_stop();
+        return ok ? 0 : 1;
+    }
+
+    FILE *hash_file = NULL;
+    if (opt.hash_out) {
+        hash_file = fopen(opt.hash_out, "wb");
+        if (!hash_file || !hashstream_write_header(hash_file, opt.seed)) {
+            fprintf(stderr, "headless: nao foi possivel gravar %s\n", opt.hash_out);
+            if (hash_file) fclose(hash_file);
+            return 2;
+        }
+    }
+
+    MemReport report = {0};
+    long long prev_totals[MEM_TAG_COUNT] = {0};
+    long sessions = 1;
+    long last_report_tick = 0;
+
+    print_mem_header();
+    double start = utils_now_seconds();
+
+    for (long tick = 1; tick <= opt.ticks; ++tick) {
+        headless_tick(&state, tick, &opt, &sessions);
+
+        if (hash_file) {
+            GameHash hash;
+            game_hash(&state, &hash);
+            hashstream_write(hash_file, (uint32_t)tick, &hash);
+        }
+
+        if (tick % opt.report_every == 0) {
+            print_mem_report(tick, sessions, &report, prev_totals, tick - last_report_tick);
+            last_report_tick = tick;
+        }
+    }
+
+    double elapsed = utils_now_seconds() - start;
+    if (hash_file) fclose(hash_file);
+    game_destroy(&state);
+
+    // Depois de liberar tudo, qualquer byte vivo é vazamento
+    long long leaked = mem_live_bytes();
+    printf("%ld ticks em %.2f s (%.0f ticks/s), %ld partidas\n",
+           opt.ticks, elapsed, elapsed > 0.0 ? opt.ticks / elapsed : 0.0, sessions);
+    printf("memoria viva apos game_destroy: %lld bytes%s\n", leaked, leaked ? " (VAZAMENTO)" : "");
+
+    trace_stop();
+    return leaked ? 1 : 0;
+}
@@ -1,11 +1,12 @@
 #include "lista.h"
+#include "mem.h"
 #include <stdlib.h>
 #include <string.h>
 
 CircularQueue *queue_create(int length) {
     if (length <= 0) return NULL;
     
-    CircularQueue *queue = (CircularQueue *)malloc(sizeof(CircularQueue));
+    CircularQueue *queue = (CircularQueue *)mem_alloc(MEM_ROWS, sizeof(CircularQueue));
     if (!queue) return NULL;
     
     queue->length = length;
@@ -17,9 +18,9 @@ CircularQueue *queue_create(int length) {
     }
     
     // Cria o primeiro nó
-    Node *first = (Node *)malloc(sizeof(Node));
+    Node *first = (Node *)mem_alloc(MEM_NODES, sizeof(Node));
     if (!first) {
-        free(queue);
+        mem_free(MEM_ROWS, queue, sizeof(CircularQueue));
         return NULL;
     }
     first->data = ' ';
@@ -28,16 +29,16 @@ CircularQueue *queue_create(int length) {
     // Cria os nós restantes e conecta em círculo
     Node *current = first;
     for (int i = 1; i < length; i++) {
-        Node *new_node = (Node *)malloc(sizeof(Node));
+        Node *new_node = (Node *)mem_alloc(MEM_NODES, sizeof(Node));
         if (!new_node) {
             // Libera nós já criados
             Node *temp = first;
             for (int j = 0; j < i; j++) {
                 Node *next = temp->next;
-                free(temp);
+                mem_free(MEM_NODES, temp, sizeof(Node));
                 temp = next;
             }
-            free(queue);
+            mem_free(MEM_ROWS, queue, sizeof(CircularQueue));
             return NULL;
         }
         new_node->data = ' ';
@@ -53,7 +54,7 @@ CircularQueue *queue_create(int length) {
 
 void queue_destroy(CircularQueue *queue) {
     if (!queue || !queue->head) {
-        if (queue) free(queue);
+        if (queue) mem_free(MEM_ROWS, queue, sizeof(CircularQueue));
         return;
     }
     
@@ -64,12 +65,12 @@ void queue_destroy(CircularQueue *queue) {
     if (current) {
         do {
             Node *next = current->next;
-            free(current);
+            mem_free(MEM_NODES, current, sizeof(Node));
             current = next;
         } while (current != start && current != NULL);
     }
     
-    free(queue);
+    mem_free(MEM_ROWS, queue, sizeof(CircularQueue));
 }
 
 void queue_set_cell(CircularQueue *queue, int index, char value) {
@@ -85,6 +86,24 @@ void queue_set_cell(CircularQueue *queue, int index, char value) {
     current->data = value;
 }
 
+int queue_set_cells(CircularQueue *queue, const char *cells, int count, int rotation) {
+    if (!queue || !queue->head || !cells) return 0;
+    if (count != queue->length) return 0;
+
+    rotation %= count;
+    if (rotation < 0) rotation += count;
+
+    // Uma passada só pela lista, lendo a origem já rotacionada
+    Node *current = queue->head;
+    int src = rotation;
+    for (int i = 0; i < count; i++) {
+        current->data = cells[src];
+        current = current->next;
+        if (++src == count) src = 0;
+    }
+    return 1;
+}
+
 char queue_get_cell(const CircularQueue *queue, int index) {
     if (!queue || !queue->head) return ' ';
     if (index < 0 || index >= queue->length) return ' ';
@@ -166,3 +185,18 @@ int queue_count_char(const CircularQueue *queue, char ch) {
     
     return count;
 }
+
+int queue_copy_cells(CircularQueue *dst, const CircularQueue *src) {
+    if (!dst || !src || !dst->head || !src->head) return 0;
+    if (dst->length != src->length) return 0;
+    
+    // Percorre as duas listas em paralelo (uma passada só)
+    Node *d = dst->head;
+    const Node *c = src->head;
+    for (int i = 0; i < src->length; i++) {
+        d->data = c->data;
+        d = d->next;
+        c = c->next;
+    }
+    return 1;
+}
@@ -44,6 +44,14 @@ void queue_rotate_right(CircularQueue *queue);
 // Counts how many cells match a given character.
 int queue_count_char(const CircularQueue *queue, char ch);
 
+// Bulk write: cell i of the queue receives cells[(rotation + i) % length], in one pass.
+// count must equal the queue length. Returns 1 on success, 0 otherwise.
+int queue_set_cells(CircularQueue *queue, const char *cells, int count, int rotation);
+
+// Copies every cell of src into dst, in order from each head (same length required).
+// Returns 1 on success, 0 if the queues are missing or have different lengths.
+int queue_copy_cells(CircularQueue *dst, const CircularQueue *src);
+
 #endif // FILA_H
 
 
@@ -6,6 +6,8 @@
 #include "ranking.h"
 #include "raylib_view.h"
 #include "sound.h"
+#include "term_view.h"
+#include "trace.h"
 
 #define RANKING_FILE "ranking.txt"
 
@@ -15,13 +17,27 @@ static void show_menu(void) {
     printf("=================\n");
     printf("Escolha uma das alternativas abaixo: \n");
     printf("1) Jogar\n");
+    printf("2) Jogar no terminal\n");
     printf("0) Sair\n");
 }
 
 int main(void) {
-    
+    // CROSSY_TRACE=arquivo.json grava um trace das fases do jogo
+    trace_start(getenv("CROSSY_TRACE"));
+
+    // Com o rankd no ar (vários jogos no mesmo host), o placar é dele; senão, o arquivo
+    ranking_service_connect(NULL);
+
     Ranking ranking;
     ranking_load(&ranking, RANKING_FILE);
+    RankingLoadReport load_report;
+    ranking_load_report(&load_report);
+    if (load_report.malformed > 0) {
+        fprintf(stderr, "%s: %u linhas ignoradas (primeira: linha %u)\n", RANKING_FILE,
+                load_report.malformed, load_report.bad_lines[0]);
+    }
+    // Gravação do ranking fora do loop do jogo (fila + thread com fsync limitado)
+    if (!ranking_service_active()) ranking_writer_start(&ranking, RANKING_FILE);
     
     int opcao = -1;
     char buffer[32];   
@@ -39,11 +55,17 @@ int main(void) {
 
         if (opcao == 1) {
             raylib_run_game(&ranking);
+        } else if (opcao == 2) {
+            utils_clear_screen();
+            term_run_game(&ranking);
         } else if (opcao == 0) {
             utils_clear_screen();
             printf("Saindo...\n");
             break;
         }
     }
+    ranking_writer_stop();
+    ranking_service_disconnect();
+    trace_stop();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "mem.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+static MemTagStats counters[MEM_TAG_COUNT];
+
+static const char *tag_names[MEM_TAG_COUNT] = { "nodes", "rows", "ranking", "assets", "rewind" };
+
+/* -------------------------------------------------------
+   CONTADORES
+ ------------------------------------------------------- */
+static void mem_account(MemTag tag, long long bytes, int allocs)
+{
+    MemTagStats *c = &counters[tag];
+    long long live = __atomic_add_fetch(&c->live_bytes, bytes, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&c->live_allocs, allocs, __ATOMIC_RELAXED);
+    if (allocs > 0) __atomic_add_fetch(&c->total_allocs, allocs, __ATOMIC_RELAXED);
+
+    // Pico: só tenta trocar enquanto o valor novo for maior
+    long long peak = __atomic_load_n(&c->peak_bytes, __ATOMIC_RELAXED);
+    while (live > peak &&
+           !__atomic_compare_exchange_n(&c->peak_bytes, &peak, live, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+void *mem_alloc(MemTag tag, size_t size)
+{
+    void *ptr = malloc(size);
+    if (ptr && tag >= 0 && tag < MEM_TAG_COUNT) mem_account(tag, (long long)size, 1);
+    return ptr;
+}
+
+void mem_free(MemTag tag, void *ptr, size_t size)
+{
+    if (!ptr) return;
+    if (tag >= 0 && tag < MEM_TAG_COUNT) mem_account(tag, -(long long)size, -1);
+    free(ptr);
+}
+
+void *mem_grow(MemTag tag, void *old, size_t old_size, size_t new_size)
+{
+    void *p = mem_alloc(tag, new_size);
+    if (!p) return NULL;
+    if (old) {
+        memcpy(p, old, old_size < new_size ? old_size : new_size);
+        mem_free(tag, old, old_size);
+    }
+    return p;
+}
+
+void mem_note(MemTag tag, long long bytes)
+{
+    if (tag < 0 || tag >= MEM_TAG_COUNT || bytes == 0) return;
+    mem_account(tag, bytes, bytes > 0 ? 1 : -1);
+}
+
+const char *mem_tag_name(MemTag tag)
+{
+    return (tag >= 0 && tag < MEM_TAG_COUNT) ? tag_names[tag] : "?";
+}
+
+long long mem_live_bytes(void)
+{
+    long long total = 0;
+    for (int i = 0; i < MEM_TAG_COUNT; ++i) total += __atomic_load_n(&counters[i].live_bytes, __ATOMIC_RELAXED);
+    return total;
+}
+
+/* -------------------------------------------------------
+   RELATÓRIO
+ ------------------------------------------------------- */
+void mem_report(MemReport *report)
+{
+    if (!report) return;
+
+    double now = utils_now_seconds();
+    double dt = (report->time > 0.0) ? now - report->time : 0.0;
+
+    for (int i = 0; i < MEM_TAG_COUNT; ++i) {
+        MemTagStats cur;
+        cur.live_bytes   = __atomic_load_n(&counters[i].live_bytes, __ATOMIC_RELAXED);
+        cur.peak_bytes   = __atomic_load_n(&counters[i].peak_bytes, __ATOMIC_RELAXED);
+        cur.live_allocs  = __atomic_load_n(&counters[i].live_allocs, __ATOMIC_RELAXED);
+        cur.total_allocs = __atomic_load_n(&counters[i].total_allocs, __ATOMIC_RELAXED);
+
+        report->allocs_per_sec[i] = (dt > 0.0)
+            ? (double)(cur.total_allocs - report->tags[i].total_allocs) / dt
+            : 0.0;
+        report->tags[i] = cur;
+    }
+    report->time = now;
+}
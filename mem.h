@@ -0,0 +1,63 @@
+#ifndef MEM_H
+#define MEM_H
+
+#include <stddef.h>
+
+// Alocador com contagem por subsistema.
+// Todo malloc/free do jogo passa por aqui com uma etiqueta, e os contadores
+// (bytes vivos, pico, alocações por segundo) aparecem no driver headless e no
+// painel de debug (F4). Contadores são atômicos: a simulação roda em outra thread.
+
+typedef enum MemTag {
+    MEM_NODES = 0,      // nós das listas circulares
+    MEM_ROWS,           // cabeçalhos das filas (uma por linha do mapa)
+    MEM_RANKING,        // estruturas do ranking
+    MEM_ASSETS,         // texturas/sons (registrados com mem_note)
+    MEM_REWIND,         // arena de checkpoints do modo prática
+    MEM_TAG_COUNT
+} MemTag;
+
+typedef struct MemTagStats {
+    long long live_bytes;
+    long long peak_bytes;
+    long long live_allocs;
+    long long total_allocs;     // acumulado desde o início (base para a taxa)
+} MemTagStats;
+
+// Leitura periódica dos contadores; guarde a anterior para calcular as taxas
+typedef struct MemReport {
+    double time;                            // utils_now_seconds da leitura (0 = nunca lido)
+    MemTagStats tags[MEM_TAG_COUNT];
+    double allocs_per_sec[MEM_TAG_COUNT];   // desde a leitura anterior do mesmo report
+} MemReport;
+
+void *mem_alloc(MemTag tag, size_t size);
+
+// size deve ser o mesmo passado para mem_alloc
+void mem_free(MemTag tag, void *ptr, size_t size);
+
+/**
+ * Realoca: aloca o novo, copia o começo e solta o antigo (não existe mem_realloc)
+ * @param old NULL aloca do zero; se não der para alocar, old continua válido
+ * @return NULL se não deu para alocar
+ */
+void *mem_grow(MemTag tag, void *old, size_t old_size, size_t new_size);
+
+/**
+ * Registra memória que não passa pelo malloc (ex.: texturas na GPU)
+ * @param bytes Positivo ao carregar, negativo ao descarregar
+ */
+void mem_note(MemTag tag, long long bytes);
+
+const char *mem_tag_name(MemTag tag);
+
+// Soma de bytes vivos de todas as etiquetas
+long long mem_live_bytes(void);
+
+/**
+ * Atualiza report com os contadores atuais
+ * As taxas usam o intervalo desde a última chamada com o mesmo report.
+ */
+void mem_report(MemReport *report);
+
+#endif // MEM_H
@@ -0,0 +1,447 @@
+#include "merge.h"
+#include "board.h"
+#include "mem.h"
+#include "names.h"
+#include "ranking.h"
+#include "trace.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MERGE_RUN_BUFFER 256        // registros lidos por vez de cada sequência
+
+// Uma entrada (arquivo): os nomes dela, que os registros de todas as suas sequências usam
+typedef struct MergeSource {
+    NameTable names;
+} MergeSource;
+
+// Uma sequência ordenada (pedaço de uma entrada gravado como placar temporário), lida em sequência
+typedef struct MergeRun {
+    Board board;
+    BoardRecord buffer[MERGE_RUN_BUFFER];
+    int buffer_count;
+    int buffer_pos;                 // cabeça = buffer[buffer_pos] (a que está no heap)
+    uint32_t next;                  // próximo registro do .dat a ler
+    const char *name;               // nome da cabeça, na tabela da entrada
+    int source;
+} MergeRun;
+
+// Partida do pedaço que está enchendo
+typedef struct MergeItem {
+    BoardRecord record;
+    const char *name;               // só resolvido na hora de ordenar (o intern pode mover a tabela)
+    uint32_t seq;                   // ordem na entrada: desempate estável
+} MergeItem;
+
+typedef struct Merge {
+    MergeSource *sources;
+    int source_count;
+    MergeRun **runs;
+    int run_count;
+    int run_cap;
+    int *heap;                      // índices de runs; topo = próxima partida da saída
+    int heap_count;
+    int heap_cap;
+    MergeItem *chunk;               // pedaço da entrada atual (MERGE_RUN)
+    int chunk_count;
+    uint32_t chunk_seq;
+    int chunk_source;
+    BoardRecord pending;            // partida cujas cópias estão sendo contadas
+    const char *pending_name;
+    uint32_t *copies;               // cópias de pending por entrada
+    uint32_t copies_total;          // 0 = nenhuma partida pendente
+    NameTable out_names;
+    BoardBuilder out;
+    char out_base[BOARD_PATH_LEN];
+    MergeReport *report;
+    int failed;
+} Merge;
+
+static int file_exists(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return 0;
+    fclose(f);
+    return 1;
+}
+
+/* -------------------------------------------------------
+   ORDEM E IDENTIDADE
+ ------------------------------------------------------- */
+// Sem hora nem semente (linha de ranking.txt, ou importada dele) nada diz qual partida é:
+// "caio;100" em duas máquinas são duas partidas
+static int has_identity(const BoardRecord *r)
+{
+    return r->time != 0 || r->seed != 0;
+}
+
+/**
+ * Ordem de todas as sequências: maior pontuação; empate = mais antiga primeiro (igual ao placar),
+ * depois semente, modo e nome
+ * A identidade de uma partida é essa chave inteira, então as cópias dela ficam lado a lado em cada
+ * sequência e saem juntas do heap: o dedupe nunca precisa guardar mais que a partida atual.
+ * Partidas sem identidade não comparam o nome: ficam na ordem da entrada (quem chama desempata).
+ */
+static int record_compare(const BoardRecord *a, const char *name_a, const BoardRecord *b, const char *name_b)
+{
+    if (a->score != b->score) return a->score > b->score ? -1 : 1;
+    if (a->time != b->time) return a->time < b->time ? -1 : 1;
+    if (a->seed != b->seed) return a->seed < b->seed ? -1 : 1;
+    if (a->mode != b->mode) return a->mode < b->mode ? -1 : 1;
+    if (!has_identity(a)) return 0;
+    return strcmp(name_a, name_b);
+}
+
+static int same_identity(const BoardRecord *a, const char *name_a, const BoardRecord *b, const char *name_b)
+{
+    return has_identity(a) && record_compare(a, name_a, b, name_b) == 0;
+}
+
+static int compare_items(const void *a, const void *b)
+{
+    const MergeItem *x = (const MergeItem *)a;
+    const MergeItem *y = (const MergeItem *)b;
+    int c = record_compare(&x->record, x->name, &y->record, y->name);
+    if (c != 0) return c;
+    return x->seq < y->seq ? -1 : x->seq > y->seq;
+}
+
+/* -------------------------------------------------------
+   SEQUÊNCIAS
+ ------------------------------------------------------- */
+static int add_run(Merge *m, const char *base, int source)
+{
+    if (m->run_count == m->run_cap) {
+        int cap = m->run_cap ? m->run_cap * 2 : 8;
+        MergeRun **runs = (MergeRun **)mem_grow(MEM_RANKING, m->runs, (size_t)m->run_cap * sizeof(*runs),
+                                                (size_t)cap * sizeof(*runs));
+        if (!runs) return 0;
+        m->runs = runs;
+        m->run_cap = cap;
+    }
+    MergeRun *run = (MergeRun *)mem_alloc(MEM_RANKING, sizeof(MergeRun));     // grande (cauda do placar)
+    if (!run) return 0;
+    memset(run, 0, sizeof(*run));
+    run->source = source;
+    if (!board_open_read(&run->board, base)) {
+        remove(run->board.dat_path);
+        remove(run->board.idx_path);
+        mem_free(MEM_RANKING, run, sizeof(MergeRun));
+        return 0;
+    }
+    m->runs[m->run_count++] = run;
+    return 1;
+}
+
+// Pedaço cheio (ou fim da entrada): ordena e grava como placar temporário, que vira mais uma sequência
+static void flush_chunk(Merge *m)
+{
+    if (m->failed) m->chunk_count = 0;
+    if (m->chunk_count == 0) return;
+    const NameTable *names = &m->sources[m->chunk_source].names;
+    for (int i = 0; i < m->chunk_count; ++i) m->chunk[i].name = names_get(names, m->chunk[i].record.name);
+    qsort(m->chunk, (size_t)m->chunk_count, sizeof(MergeItem), compare_items);
+
+    char base[BOARD_PATH_LEN + 16];
+    snprintf(base, sizeof(base), "%s.run%d", m->out_base, m->run_count);
+    BoardBuilder builder;
+    int ok = board_build_start(&builder, base);
+    for (int i = 0; ok && i < m->chunk_count; ++i) ok = board_build_add(&builder, &m->chunk[i].record);
+    if (ok) ok = board_build_finish(&builder);
+    else board_build_abort(&builder);
+    if (ok) ok = add_run(m, base, m->chunk_source);
+    if (!ok) m->failed = 1;
+    m->chunk_count = 0;
+}
+
+static void chunk_add(Merge *m, const BoardRecord *r)
+{
+    MergeItem *item = &m->chunk[m->chunk_count++];
+    item->record = *r;
+    item->seq = m->chunk_seq++;
+    if (m->chunk_count == MERGE_RUN) flush_chunk(m);
+}
+
+static void text_line(void *ctx, const char *name, int score)
+{
+    Merge *m = (Merge *)ctx;
+    if (m->failed) return;
+    BoardRecord r;
+    memset(&r, 0, sizeof(r));
+    r.score = score;
+    r.name = names_intern(&m->sources[m->chunk_source].names, name, NULL);
+    if (r.name == NAMES_NONE) {
+        m->failed = 1;
+        return;
+    }
+    chunk_add(m, &r);
+}
+
+// Placar de entrada: só leitura, na ordem do .dat (o pedaço reordena)
+static int read_board(Merge *m, const char *input, const char *base)
+{
+    Board *board = (Board *)mem_alloc(MEM_RANKING, sizeof(Board));
+    if (!board) return 0;
+    if (!board_open_read(board, base)) {
+        fprintf(stderr, "merge: nao foi possivel abrir %s\n", input);
+        mem_free(MEM_RANKING, board, sizeof(Board));
+        return 0;
+    }
+    BoardRecord batch[MERGE_RUN_BUFFER];
+    uint32_t first = 0;
+    while (first < board->record_count && !m->failed) {
+        int n = board_read_records(board, first, batch, MERGE_RUN_BUFFER);
+        if (n <= 0) {
+            fprintf(stderr, "merge: erro lendo %s\n", board->dat_path);
+            m->failed = 1;
+            break;
+        }
+        for (int i = 0; i < n && !m->failed; ++i) chunk_add(m, &batch[i]);
+        first += (uint32_t)n;
+    }
+    board_close(board);
+    mem_free(MEM_RANKING, board, sizeof(Board));
+    flush_chunk(m);
+    return !m->failed;
+}
+
+static int open_input(Merge *m, const char *input, int source)
+{
+    char base[BOARD_PATH_LEN], path[BOARD_PATH_LEN + 8];
+    board_base_path(base, sizeof(base), input);
+    if (strcmp(base, m->out_base) == 0) {
+        fprintf(stderr, "merge: %s e a propria saida\n", input);
+        return 0;
+    }
+
+    m->chunk_source = source;
+    m->chunk_count = 0;
+    m->chunk_seq = 0;
+    snprintf(path, sizeof(path), "%s.dat", base);
+    if (file_exists(path)) {
+        names_path(path, sizeof(path), base);
+        names_load(&m->sources[source].names, path);
+        return read_board(m, input, base);
+    }
+
+    // ranking.txt antigo
+    RankingLoadReport text;
+    memset(&text, 0, sizeof(text));
+    if (!ranking_scan_text(input, text_line, m, &text)) {
+        fprintf(stderr, "merge: nao foi possivel abrir %s\n", input);
+        return 0;
+    }
+    flush_chunk(m);
+    m->report->malformed += text.malformed;
+    if (text.malformed > 0) {
+        fprintf(stderr, "merge: %s: %u linha(s) ignorada(s) (primeira: linha %u)\n", input, text.malformed,
+                text.bad_lines[0]);
+    }
+    return !m->failed;
+}
+
+/* -------------------------------------------------------
+   HEAP DAS CABEÇAS
+ ------------------------------------------------------- */
+// Lê o próximo bloco da sequência; 0 no fim (ou erro de leitura, que marca a junção como falha)
+static int run_fill(Merge *m, MergeRun *run)
+{
+    run->buffer_pos = 0;
+    run->buffer_count = board_read_records(&run->board, run->next, run->buffer, MERGE_RUN_BUFFER);
+    if (run->buffer_count <= 0) {
+        run->buffer_count = 0;
+        if (run->next < run->board.record_count) m->failed = 1;
+        return 0;
+    }
+    run->next += (uint32_t)run->buffer_count;
+    return 1;
+}
+
+static void run_name(Merge *m, MergeRun *run)
+{
+    run->name = names_get(&m->sources[run->source].names, run->buffer[run->buffer_pos].name);
+}
+
+// Ordem de record_compare; empate = sequência de número menor (ordem das entradas e dos pedaços)
+static int heap_before(const Merge *m, int a, int b)
+{
+    const MergeRun *x = m->runs[a], *y = m->runs[b];
+    int c = record_compare(&x->buffer[x->buffer_pos], x->name, &y->buffer[y->buffer_pos], y->name);
+    if (c != 0) return c < 0;
+    return a < b;
+}
+
+static void heap_sift_down(Merge *m, int i)
+{
+    for (;;) {
+        int best = i, l = 2 * i + 1, r = l + 1;
+        if (l < m->heap_count && heap_before(m, m->heap[l], m->heap[best])) best = l;
+        if (r < m->heap_count && heap_before(m, m->heap[r], m->heap[best])) best = r;
+        if (best == i) return;
+        int t = m->heap[i];
+        m->heap[i] = m->heap[best];
+        m->heap[best] = t;
+        i = best;
+    }
+}
+
+static void heap_build(Merge *m)
+{
+    m->heap_count = 0;
+    for (int r = 0; r < m->run_count; ++r) {
+        MergeRun *run = m->runs[r];
+        if (!run_fill(m, run)) continue;
+        run_name(m, run);
+        m->heap[m->heap_count++] = r;
+    }
+    for (int i = m->heap_count / 2 - 1; i >= 0; --i) heap_sift_down(m, i);
+}
+
+// Tira a cabeça do topo e põe a seguinte da mesma sequência no lugar
+static void heap_advance(Merge *m)
+{
+    MergeRun *run = m->runs[m->heap[0]];
+    if (++run->buffer_pos < run->buffer_count || run_fill(m, run)) run_name(m, run);
+    else m->heap[0] = m->heap[--m->heap_count];
+    if (m->heap_count > 0) heap_sift_down(m, 0);
+}
+
+/* -------------------------------------------------------
+   DEDUPE
+ ------------------------------------------------------- */
+static int write_record(Merge *m, const BoardRecord *record, const char *name)
+{
+    BoardRecord r = *record;
+    r.name = names_intern(&m->out_names, name, NULL);
+    if (r.name == NAMES_NONE || !board_build_add(&m->out, &r)) return 0;
+    m->report->written++;
+    return 1;
+}
+
+/**
+ * Grava a partida pendente
+ * Fica com as cópias da entrada que a tem mais vezes; as das outras entradas são repetidas.
+ */
+static int pending_flush(Merge *m)
+{
+    if (m->copies_total == 0) return 1;
+    uint32_t best = 0;
+    for (int s = 0; s < m->source_count; ++s) {
+        if (m->copies[s] > best) best = m->copies[s];
+        m->copies[s] = 0;
+    }
+    m->report->duplicates += m->copies_total - best;
+    m->copies_total = 0;
+    for (uint32_t i = 0; i < best; ++i) {
+        if (!write_record(m, &m->pending, m->pending_name)) return 0;
+    }
+    return 1;
+}
+
+static int merge_take(Merge *m, const BoardRecord *r, const char *name, int source)
+{
+    m->report->read++;
+    if (m->copies_total > 0 && same_identity(&m->pending, m->pending_name, r, name)) {
+        m->copies[source]++;
+        m->copies_total++;
+        return 1;
+    }
+    if (!pending_flush(m)) return 0;
+    if (!has_identity(r)) return write_record(m, r, name);
+    m->pending = *r;
+    m->pending_name = name;         // tabela da entrada: não muda mais depois de aberta
+    m->copies[source] = 1;
+    m->copies_total = 1;
+    return 1;
+}
+
+/* -------------------------------------------------------
+   API
+ ------------------------------------------------------- */
+static int merge_all(Merge *m)
+{
+    heap_build(m);
+    while (m->heap_count > 0 && !m->failed) {
+        MergeRun *run = m->runs[m->heap[0]];
+        if (!merge_take(m, &run->buffer[run->buffer_pos], run->name, run->source)) return 0;
+        heap_advance(m);
+    }
+    return !m->failed && pending_flush(m);
+}
+
+static void merge_free(Merge *m)
+{
+    for (int r = 0; r < m->run_count; ++r) {
+        MergeRun *run = m->runs[r];
+        board_close(&run->board);
+        remove(run->board.dat_path);
+        remove(run->board.idx_path);
+        mem_free(MEM_RANKING, run, sizeof(MergeRun));
+    }
+    if (m->runs) mem_free(MEM_RANKING, m->runs, (size_t)m->run_cap * sizeof(MergeRun *));
+    if (m->heap) mem_free(MEM_RANKING, m->heap, (size_t)m->heap_cap * sizeof(int));
+    for (int s = 0; s < m->source_count; ++s) names_free(&m->sources[s].names);
+    if (m->sources) mem_free(MEM_RANKING, m->sources, (size_t)m->source_count * sizeof(MergeSource));
+    if (m->copies) mem_free(MEM_RANKING, m->copies, (size_t)m->source_count * sizeof(uint32_t));
+    if (m->chunk) mem_free(MEM_RANKING, m->chunk, MERGE_RUN * sizeof(MergeItem));
+    names_free(&m->out_names);
+}
+int merge_rankings(const char *const *inputs, int count, const char *output, MergeReport *report)
+{
+    static MergeReport scratch;
+    if (!report) report = &scratch;
+    memset(report, 0, sizeof(*report));
+    if (!inputs || count <= 0 || !output) return 0;
+    TRACE_BEGIN("merge_rankings");
+    double start = utils_now_seconds();
+
+    Merge m;
+    memset(&m, 0, sizeof(m));
+    m.report = report;
+    board_base_path(m.out_base, sizeof(m.out_base), output);
+
+    char path[BOARD_PATH_LEN + 8];
+    snprintf(path, sizeof(path), "%s.dat", m.out_base);
+    int ok = !file_exists(path);
+    if (!ok) fprintf(stderr, "merge: %s ja existe\n", path);
+
+    m.source_count = count;
+    m.sources = ok ? (MergeSource *)mem_alloc(MEM_RANKING, (size_t)count * sizeof(MergeSource)) : NULL;
+    if (m.sources) {
+        for (int s = 0; s < count; ++s) names_init(&m.sources[s].names);
+        m.copies = (uint32_t *)mem_alloc(MEM_RANKING, (size_t)count * sizeof(uint32_t));
+        if (m.copies) memset(m.copies, 0, (size_t)count * sizeof(uint32_t));
+    } else {
+        m.source_count = 0;
+    }
+    m.chunk = ok ? (MergeItem *)mem_alloc(MEM_RANKING, MERGE_RUN * sizeof(MergeItem)) : NULL;
+    ok = m.sources && m.copies && m.chunk;
+
+    for (int s = 0; ok && s < count; ++s) ok = open_input(&m, inputs[s], s);
+    report->inputs = count;
+    report->runs = m.run_count;
+
+    if (ok) {
+        m.heap_cap = m.run_count ? m.run_count : 1;
+        m.heap = (int *)mem_alloc(MEM_RANKING, (size_t)m.heap_cap * sizeof(int));
+        ok = m.heap && board_build_start(&m.out, m.out_base);
+        if (ok) {
+            ok = merge_all(&m);
+            // Nomes antes do placar: um placar sem o .names ao lado perderia os nomes
+            names_path(path, sizeof(path), m.out_base);
+            remove(path);                   // sobra de outra junção não pode passar por nomes desta
+            FILE *names_out = ok ? names_open(&m.out_names, path) : NULL;
+            ok = names_out != NULL;
+            if (names_out) fclose(names_out);
+            if (ok) ok = board_build_finish(&m.out);
+            else board_build_abort(&m.out);
+            if (!ok) remove(path);
+        }
+    }
+    merge_free(&m);
+
+    report->ms = (utils_now_seconds() - start) * 1000.0;
+    TRACE_END("merge_rankings");
+    return ok;
+}
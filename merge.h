@@ -0,0 +1,46 @@
+#ifndef MERGE_H
+#define MERGE_H
+
+#include <stdint.h>
+
+// Junção de rankings de várias máquinas num placar global (board.h).
+//
+// - Cada entrada é lida uma vez, só leitura, em pedaços de MERGE_RUN partidas; cada pedaço é
+//   ordenado e gravado como placar temporário (<saída>.runN, apagado no fim). Um heap com a cabeça
+//   de cada pedaço faz o k-way merge.
+// - Ordem: maior pontuação; empate = mais antiga primeiro, depois semente, modo e nome. A partida
+//   inteira é a chave, então as cópias de uma partida chegam juntas ao topo do heap.
+// - Repetidas: a mesma partida (nome, pontuação, hora, semente, modo) que aparece em mais de uma
+//   entrada (placar copiado, máquina sincronizada) entra uma vez. Dentro de uma entrada nada é
+//   descartado; se ela tem a mesma partida n vezes, a saída fica com o maior n entre as entradas.
+//   Partidas sem hora e sem semente (ranking.txt antigo, ou importadas dele para o placar) não
+//   têm como ser reconhecidas: nunca são descartadas, mesmo com nome e pontuação iguais, e ficam
+//   na ordem em que estavam.
+// - Memória: um pedaço, uma sequência aberta (~40 KB) a cada MERGE_RUN partidas de entrada, os
+//   nomes distintos de cada entrada e um contador de cópias por entrada. Empates grandes não
+//   custam nada; o que cresce com as entradas é o número de sequências (e arquivos abertos).
+// - Disco: os pedaços somam o tamanho das entradas (20 bytes por partida) até o fim da junção.
+
+#define MERGE_RUN 65536             // partidas ordenadas por vez (cada pedaço vira uma sequência)
+
+typedef struct MergeReport {
+    int inputs;
+    int runs;                       // sequências intercaladas (pedaços de todas as entradas)
+    uint32_t read;                  // partidas lidas de todas as entradas
+    uint32_t duplicates;            // descartadas por já estarem em outra entrada
+    uint32_t written;
+    uint32_t malformed;             // linhas ruins nos ranking.txt (ignoradas)
+    double ms;
+} MergeReport;
+
+/**
+ * Junta os rankings num placar novo
+ * @param inputs Placar (caminho com ou sem extensão: "loja1/ranking.txt" usa loja1/ranking.dat
+ *               se ele existir) ou ranking.txt antigo
+ * @param output Caminho do ranking de saída (gera <base>.dat/.idx/.names); não pode existir
+ * @param report Opcional
+ * @return 0 em erro (entrada que não abre, saída já existe, erro de escrita); nada fica pela metade
+ */
+int merge_rankings(const char *const *inputs, int count, const char *output, MergeReport *report);
+
+#endif // MERGE_H
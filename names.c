@@ -0,0 +1,209 @@
+#include "names.h"
+#include "mem.h"
+#include "utils.h"
+#include <string.h>
+
+#define NAMES_INITIAL_SLOTS 64
+
+static uint32_t name_hash(const char *name)
+{
+    uint32_t h = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)name; *p; ++p) {
+        h ^= *p;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+void names_init(NameTable *table)
+{
+    if (table) memset(table, 0, sizeof(*table));
+}
+
+void names_free(NameTable *table)
+{
+    if (!table) return;
+    if (table->chars) mem_free(MEM_RANKING, table->chars, table->chars_cap);
+    if (table->offsets) mem_free(MEM_RANKING, table->offsets, table->cap * sizeof(uint32_t));
+    if (table->hashes) mem_free(MEM_RANKING, table->hashes, table->cap * sizeof(uint32_t));
+    if (table->slots) mem_free(MEM_RANKING, table->slots, table->slot_cap * sizeof(uint32_t));
+    names_init(table);
+}
+
+/* -------------------------------------------------------
+   HASH
+ ------------------------------------------------------- */
+// Slot do nome (com o id) ou o slot vazio onde ele entraria
+static uint32_t find_slot(const NameTable *table, const char *name, uint32_t hash)
+{
+    uint32_t mask = table->slot_cap - 1;
+    uint32_t i = hash & mask;
+    for (;;) {
+        uint32_t slot = table->slots[i];
+        if (slot == 0) return i;
+        if (table->hashes[slot - 1] == hash && strcmp(table->chars + table->offsets[slot - 1], name) == 0) return i;
+        i = (i + 1) & mask;
+    }
+}
+
+static int rehash(NameTable *table, uint32_t slot_cap)
+{
+    uint32_t *slots = (uint32_t *)mem_alloc(MEM_RANKING, slot_cap * sizeof(uint32_t));
+    if (!slots) return 0;
+    memset(slots, 0, slot_cap * sizeof(uint32_t));
+    if (table->slots) mem_free(MEM_RANKING, table->slots, table->slot_cap * sizeof(uint32_t));
+    table->slots = slots;
+    table->slot_cap = slot_cap;
+    for (uint32_t id = 0; id < table->count; ++id) {
+        uint32_t i = find_slot(table, table->chars + table->offsets[id], table->hashes[id]);
+        if (table->slots[i] == 0) table->slots[i] = id + 1;    // repetido no arquivo: fica o primeiro
+    }
+    return 1;
+}
+
+/* -------------------------------------------------------
+   INSERÇÃO
+ ------------------------------------------------------- */
+// Acrescenta o nome com o próximo id, sem olhar se já existe (o arquivo manda na numeração)
+static uint32_t append_name(NameTable *table, const char *name, uint32_t hash)
+{
+    uint32_t len = (uint32_t)strlen(name) + 1;
+    if (table->chars_used + len > table->chars_cap) {
+        uint32_t cap = table->chars_cap ? table->chars_cap : 1024;
+        while (table->chars_used + len > cap) cap *= 2;
+        char *chars = (char *)mem_grow(MEM_RANKING, table->chars, table->chars_cap, cap);
+        if (!chars) return NAMES_NONE;
+        table->chars = chars;
+        table->chars_cap = cap;
+    }
+    if (table->count == table->cap) {
+        uint32_t cap = table->cap ? table->cap * 2 : 64;
+        uint32_t *offsets = (uint32_t *)mem_alloc(MEM_RANKING, cap * sizeof(uint32_t));
+        uint32_t *hashes = (uint32_t *)mem_alloc(MEM_RANKING, cap * sizeof(uint32_t));
+        if (!offsets || !hashes) {
+            if (offsets) mem_free(MEM_RANKING, offsets, cap * sizeof(uint32_t));
+            if (hashes) mem_free(MEM_RANKING, hashes, cap * sizeof(uint32_t));
+            return NAMES_NONE;
+        }
+        if (table->cap) {
+            memcpy(offsets, table->offsets, table->count * sizeof(uint32_t));
+            memcpy(hashes, table->hashes, table->count * sizeof(uint32_t));
+            mem_free(MEM_RANKING, table->offsets, table->cap * sizeof(uint32_t));
+            mem_free(MEM_RANKING, table->hashes, table->cap * sizeof(uint32_t));
+        }
+        table->offsets = offsets;
+        table->hashes = hashes;
+        table->cap = cap;
+    }
+    if ((table->count + 1) * 2 >= table->slot_cap) {
+        if (!rehash(table, table->slot_cap ? table->slot_cap * 2 : NAMES_INITIAL_SLOTS)) return NAMES_NONE;
+    }
+
+    uint32_t id = table->count++;
+    table->offsets[id] = table->chars_used;
+    table->hashes[id] = hash;
+    memcpy(table->chars + table->chars_used, name, len);
+    table->chars_used += len;
+
+    uint32_t i = find_slot(table, name, hash);
+    if (table->slots[i] == 0) table->slots[i] = id + 1;
+    return id;
+}
+
+uint32_t names_find(const NameTable *table, const char *name)
+{
+    if (!table || !name || table->slot_cap == 0) return NAMES_NONE;
+    uint32_t slot = table->slots[find_slot(table, name, name_hash(name))];
+    return slot ? slot - 1 : NAMES_NONE;
+}
+
+uint32_t names_intern(NameTable *table, const char *name, int *created)
+{
+    if (created) *created = 0;
+    if (!table || !name) return NAMES_NONE;
+    uint32_t hash = name_hash(name);
+    if (table->slot_cap > 0) {
+        uint32_t slot = table->slots[find_slot(table, name, hash)];
+        if (slot) return slot - 1;
+    }
+    uint32_t id = append_name(table, name, hash);
+    if (created && id != NAMES_NONE) *created = 1;
+    return id;
+}
+
+const char *names_get(const NameTable *table, uint32_t id)
+{
+    if (!table || id >= table->count) return "?";
+    return table->chars + table->offsets[id];
+}
+
+/* -------------------------------------------------------
+   ARQUIVO
+ ------------------------------------------------------- */
+uint32_t names_load(NameTable *table, const char *path)
+{
+    if (!table) return 0;
+    names_free(table);
+    FILE *f = path ? fopen(path, "r") : NULL;
+    if (!f) return 0;
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        char *end = strchr(line, '\n');
+        if (!end) break;                // linha cortada: o registro que a usaria também não existe
+        *end = '\0';
+        if (end > line && end[-1] == '\r') end[-1] = '\0';
+        if (append_name(table, line, name_hash(line)) == NAMES_NONE) break;
+    }
+    fclose(f);
+    return table->count;
+}
+
+// Linhas completas no arquivo; -1 se a última está cortada
+static long count_lines(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return 0;
+    long lines = 0;
+    int c, last = '\n';
+    while ((c = fgetc(f)) != EOF) {
+        if (c == '\n') lines++;
+        last = c;
+    }
+    fclose(f);
+    return last == '\n' ? lines : -1;
+}
+
+static int rewrite(const NameTable *table, const char *path)
+{
+    char tmp[600];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *f = fopen(tmp, "wb");
+    if (!f) return 0;
+    int ok = 1;
+    for (uint32_t id = 0; ok && id < table->count; ++id) {
+        ok = fprintf(f, "%s\n", table->chars + table->offsets[id]) > 0;
+    }
+    if (ok) ok = utils_fsync_file(f);
+    if (fclose(f) != 0) ok = 0;
+    if (ok) ok = utils_replace_file(tmp, path);
+    if (!ok) remove(tmp);
+    return ok;
+}
+
+FILE *names_open(const NameTable *table, const char *path)
+{
+    if (!table || !path) return NULL;
+    if (count_lines(path) != (long)table->count && !rewrite(table, path)) return NULL;
+    return fopen(path, "ab");
+}
+
+int names_write(FILE *file, const char *name)
+{
+    return file && name && fprintf(file, "%s\n", name) > 0 && fflush(file) == 0;
+}
+
+void names_path(char *out, int size, const char *base_path)
+{
+    if (!out || size <= 0) return;
+    snprintf(out, (size_t)size, "%s.names", base_path ? base_path : "ranking");
+}
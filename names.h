@@ -0,0 +1,64 @@
+#ifndef NAMES_H
+#define NAMES_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Tabela de nomes internados: cada nome de jogador existe uma vez só, e o resto do
+// ranking (registros do placar, índice por jogador) guarda o id dele (uint32).
+//
+// - Memória: os nomes ficam um atrás do outro num buffer só (chars), com offsets[id].
+// - Busca: hash aberto (FNV-1a, sondagem linear) de nome -> id, O(1).
+// - Disco: <base>.names, um nome por linha, só acrescentado; a linha k é o id k.
+
+#define NAMES_NONE 0xFFFFFFFFu
+
+typedef struct NameTable {
+    char *chars;                    // nomes seguidos, cada um terminado em '\0'
+    uint32_t chars_used;
+    uint32_t chars_cap;
+    uint32_t *offsets;              // id -> início do nome em chars
+    uint32_t *hashes;               // id -> hash do nome (sondagem só chama strcmp quando bate)
+    uint32_t count;
+    uint32_t cap;
+    uint32_t *slots;                // id + 1 (0 = vazio)
+    uint32_t slot_cap;              // potência de 2, sempre mais que o dobro de count
+} NameTable;
+
+void names_init(NameTable *table);
+void names_free(NameTable *table);
+
+// Id do nome, ou NAMES_NONE se ele nunca apareceu
+uint32_t names_find(const NameTable *table, const char *name);
+
+/**
+ * Id do nome, criando se for novo (ids novos são sempre count-1: seguem a ordem do arquivo)
+ * @param created Opcional: 1 se o nome foi criado agora (precisa ir para o arquivo)
+ * @return NAMES_NONE se faltou memória
+ */
+uint32_t names_intern(NameTable *table, const char *name, int *created);
+
+// Nome do id ("?" se o id não existe, ex.: linha perdida num crash)
+const char *names_get(const NameTable *table, uint32_t id);
+
+/**
+ * Recarrega a tabela do arquivo (linha cortada no fim é ignorada)
+ * @return Quantos nomes foram lidos (0 se o arquivo não existe)
+ */
+uint32_t names_load(NameTable *table, const char *path);
+
+/**
+ * Abre o arquivo para acrescentar nomes novos
+ * Se ele não bate com a tabela (linha cortada no fim, nomes que só existem na memória),
+ * é reescrito a partir da tabela antes (temporário + troca).
+ * @return NULL se não deu para abrir
+ */
+FILE *names_open(const NameTable *table, const char *path);
+
+// Acrescenta uma linha no arquivo aberto (fflush incluso). Retorna 1 em sucesso
+int names_write(FILE *file, const char *name);
+
+// "<base>.names"
+void names_path(char *out, int size, const char *base_path);
+
+#endif // NAMES_H
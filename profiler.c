@@ -0,0 +1,146 @@
+#include "profiler.h"
+
+#ifdef ENABLE_PROFILER
+
+#include "raylib.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *PHASE_NAMES[PROF_PHASE_COUNT] = {
+    "input", "update", "mapa", "hud", "blit", "som"
+};
+
+static const Color PHASE_COLORS[PROF_PHASE_COUNT] = {
+    {255, 193, 7, 255},   // input
+    {244, 67, 54, 255},   // update
+    {76, 175, 80, 255},   // mapa
+    {33, 150, 243, 255},  // hud
+    {156, 39, 176, 255},  // blit
+    {0, 188, 212, 255}    // som
+};
+
+// Ring buffer: tempos (ms) de cada fase e duração total de cada frame
+static float history[PROF_HISTORY][PROF_PHASE_COUNT];
+static float frame_ms[PROF_HISTORY];
+static int history_pos = 0;        // próximo slot a escrever
+static int history_count = 0;
+
+static double phase_start[PROF_PHASE_COUNT];
+static double current[PROF_PHASE_COUNT];   // acumulado do frame em andamento
+static double last_frame_end = 0.0;
+static double last_budget_ms = 16.7;
+
+static int missed_total = 0;
+static int overlay_on = 0;
+
+void prof_begin(ProfPhase phase)
+{
+    phase_start[phase] = utils_now_seconds();
+}
+
+void prof_end(ProfPhase phase)
+{
+    current[phase] += (utils_now_seconds() - phase_start[phase]) * 1000.0;
+}
+
+void prof_add_ms(ProfPhase phase, double ms)
+{
+    current[phase] += ms;
+}
+
+void prof_frame_end(double budget_ms)
+{
+    double now = utils_now_seconds();
+    double total = (last_frame_end > 0.0) ? (now - last_frame_end) * 1000.0 : 0.0;
+    last_frame_end = now;
+    last_budget_ms = budget_ms;
+
+    for (int p = 0; p < PROF_PHASE_COUNT; ++p) {
+        history[history_pos][p] = (float)current[p];
+        current[p] = 0.0;
+    }
+    frame_ms[history_pos] = (float)total;
+    if (total > budget_ms * 1.25) missed_total++;   // folga para o jitter do vsync
+
+    history_pos = (history_pos + 1) % PROF_HISTORY;
+    if (history_count < PROF_HISTORY) history_count++;
+}
+
+void prof_toggle_overlay(void)
+{
+    overlay_on = !overlay_on;
+}
+
+static int compare_float(const void *a, const void *b)
+{
+    float fa = *(const float *)a, fb = *(const float *)b;
+    return (fa > fb) - (fa < fb);
+}
+
+// p50/p99/max de uma coluna do histórico (phase < 0 = duração do frame)
+static void column_stats(int phase, float *p50, float *p99, float *max)
+{
+    static float sorted[PROF_HISTORY];
+    for (int i = 0; i < history_count; ++i) {
+        sorted[i] = (phase < 0) ? frame_ms[i] : history[i][phase];
+    }
+    qsort(sorted, (size_t)history_count, sizeof(float), compare_float);
+    *p50 = sorted[(history_count - 1) * 50 / 100];
+    *p99 = sorted[(history_count - 1) * 99 / 100];
+    *max = sorted[history_count - 1];
+}
+
+void prof_draw_overlay(int x, int y)
+{
+    if (!overlay_on || history_count == 0) return;
+
+    const int w = PROF_HISTORY * 2 + 20;
+    const int graph_h = 80;
+    const int line_h = 16;
+    const int h = graph_h + line_h * (PROF_PHASE_COUNT + 3) + 30;
+    DrawRectangle(x, y, w, h, (Color){0, 0, 0, 190});
+
+    // Gráfico empilhado por frame (mais antigo à esquerda); escala: 2x o orçamento
+    int gx = x + 10, gy = y + 10;
+    float scale = graph_h / (float)(last_budget_ms * 2.0);
+    for (int i = 0; i < history_count; ++i) {
+        int idx = (history_pos - history_count + i + PROF_HISTORY) % PROF_HISTORY;
+        float base = (float)(gy + graph_h);
+        for (int p = 0; p < PROF_PHASE_COUNT; ++p) {
+            float bar = history[idx][p] * scale;
+            if (bar <= 0.0f) continue;
+            if (base - bar < gy) bar = base - gy;
+            DrawRectangle(gx + i * 2, (int)(base - bar), 2, (int)bar + 1, PHASE_COLORS[p]);
+            base -= bar;
+        }
+        if (frame_ms[idx] > last_budget_ms * 1.25) DrawRectangle(gx + i * 2, gy, 2, 3, RED);
+    }
+    int budget_y = gy + graph_h - (int)(last_budget_ms * scale);
+    DrawLine(gx, budget_y, gx + PROF_HISTORY * 2, budget_y, WHITE);
+
+    // Tabela p50 / p99 / max por fase
+    int ty = gy + graph_h + 8;
+    DrawText("fase       p50     p99     max (ms)", gx, ty, 14, LIGHTGRAY);
+    ty += line_h;
+    float p50, p99, max;
+    for (int p = 0; p < PROF_PHASE_COUNT; ++p) {
+        column_stats(p, &p50, &p99, &max);
+        DrawText(TextFormat("%-8s %6.2f  %6.2f  %6.2f", PHASE_NAMES[p], p50, p99, max),
+                 gx, ty, 14, PHASE_COLORS[p]);
+        ty += line_h;
+    }
+    column_stats(-1, &p50, &p99, &max);
+    DrawText(TextFormat("frame    %6.2f  %6.2f  %6.2f", p50, p99, max), gx, ty, 14, WHITE);
+    ty += line_h;
+
+    int missed_window = 0;
+    for (int i = 0; i < history_count; ++i) {
+        if (frame_ms[i] > last_budget_ms * 1.25) missed_window++;
+    }
+    DrawText(TextFormat("orcamento %.1f ms | estourados: %d nos ultimos %d, %d no total",
+                        last_budget_ms, missed_window, history_count, missed_total),
+             gx, ty, 14, missed_window ? RED : GREEN);
+}
+
+#endif // ENABLE_PROFILER
@@ -0,0 +1,47 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Profiler de fases do frame com overlay (F3).
+// Guarda os tempos dos últimos PROF_HISTORY frames num ring buffer fixo (sem alocação).
+// Só existe quando compilado com -DENABLE_PROFILER; senão as macros somem por completo.
+
+typedef enum ProfPhase {
+    PROF_INPUT = 0,     // teclado + lógica das telas
+    PROF_UPDATE,        // game_update (medido na thread de simulação)
+    PROF_PLAYFIELD,     // desenho das linhas do mapa
+    PROF_HUD,           // HUD e telas de menu
+    PROF_BLIT,          // cópia do alvo virtual para a tela
+    PROF_SOUND,         // sound_update
+    PROF_PHASE_COUNT
+} ProfPhase;
+
+#define PROF_HISTORY 240
+
+#ifdef ENABLE_PROFILER
+
+void prof_begin(ProfPhase phase);
+void prof_end(ProfPhase phase);
+void prof_add_ms(ProfPhase phase, double ms);      // tempo medido fora do thread do render
+void prof_frame_end(double budget_ms);             // fecha o frame atual (chamar 1x por frame)
+void prof_toggle_overlay(void);
+void prof_draw_overlay(int x, int y);              // desenha em coordenadas da tela
+
+#define PROF_BEGIN(phase)        prof_begin(phase)
+#define PROF_END(phase)          prof_end(phase)
+#define PROF_ADD_MS(phase, ms)   prof_add_ms((phase), (ms))
+#define PROF_FRAME_END(budget)   prof_frame_end(budget)
+#define PROF_TOGGLE()            prof_toggle_overlay()
+#define PROF_DRAW(x, y)          prof_draw_overlay((x), (y))
+
+#else
+
+#define PROF_BEGIN(phase)        ((void)0)
+#define PROF_END(phase)          ((void)0)
+#define PROF_ADD_MS(phase, ms)   ((void)0)
+#define PROF_FRAME_END(budget)   ((void)0)
+#define PROF_TOGGLE()            ((void)0)
+#define PROF_DRAW(x, y)          ((void)0)
+
+#endif // ENABLE_PROFILER
+
+#endif // PROFILER_H
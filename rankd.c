@@ -0,0 +1,292 @@
+// Placar compartilhado: um processo dono do ranking, e os jogos do mesmo host falam com ele
+// por um socket Unix (rankproto.h) em vez de cada um escrever no próprio arquivo.
+// Um laço só (poll) atende todos os clientes: as inserções ficam em série, e a gravação em
+// disco é a mesma do jogo (fila + thread de escrita, fsync com frequência limitada).
+//
+// Uso: rankd [--socket CAMINHO] [--file ranking.txt]
+//   --socket CAMINHO   socket do daemon (padrão: $CROSSY_RANKD ou RANKPROTO_DEFAULT_SOCKET)
+//   --file ARQ         ranking que o daemon carrega e grava (padrão ranking.txt)
+// Encerra com SIGINT/SIGTERM gravando o que estava na fila.
+//
+// Carga: rankd --bench N [--clients K] [--socket CAMINHO]
+//   K clientes (threads, uma conexão cada) mandam N inserções cada para um daemon já no ar
+//   e medem inserções por segundo e a latência de ida e volta.
+//
+// Só POSIX: no Windows o jogo usa o arquivo direto.
+
+#define _POSIX_C_SOURCE 200809L  // poll/sigaction com -std=c99
+
+#include "rankproto.h"
+#include "ranking.h"
+#include "utils.h"
+#include "trace.h"
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define RANKD_MAX_CLIENTS 64
+#define RANKD_POLL_MS 200           // confere o pedido de parada nesse intervalo
+#define RANKD_BENCH_MAX_CLIENTS 32
+
+typedef struct RankdClient {
+    int fd;                         // -1 = livre
+    RankRequest req;
+    int have;                       // bytes de req já recebidos
+} RankdClient;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop_requested = 1;
+}
+
+/* -------------------------------------------------------
+   ATENDIMENTO
+ ------------------------------------------------------- */
+static int reply(int fd, RankStatus status, uint32_t place, uint32_t total, const void *payload, uint32_t size)
+{
+    RankReply r;
+    r.status = (uint32_t)status;
+    r.place = place;
+    r.total = total;
+    r.size = size;
+    return rankproto_send(fd, &r, (int)sizeof(r)) && (size == 0 || rankproto_send(fd, payload, (int)size));
+}
+
+// Retorna 0 se o cliente deve ser desconectado
+static int handle(int fd, RankRequest *req, Ranking *ranking, const char *file)
+{
+    req->name[MAX_NAME_LEN] = '\0';
+    if (req->version != RANKPROTO_VERSION) {
+        reply(fd, RANK_STATUS_ERROR, 0, 0, NULL, 0);
+        return 0;
+    }
+
+    RankingMode mode = (RankingMode)req->mode;
+    if (mode < RANKING_MODE_ALL || mode >= RANKING_MODE_COUNT || (req->op == RANK_OP_ADD && mode == RANKING_MODE_ALL)) {
+        return reply(fd, RANK_STATUS_ERROR, 0, 0, NULL, 0);
+    }
+
+    switch (req->op) {
+    case RANK_OP_ADD:
+        ranking_add(ranking, mode, req->seed, req->name, req->score, file);
+        return reply(fd, RANK_STATUS_OK, ranking_place_of(ranking, mode, req->score), ranking_total_runs(ranking, mode),
+                     NULL, 0);
+    case RANK_OP_SNAPSHOT:
+        return reply(fd, RANK_STATUS_OK, 0, ranking_total_runs(ranking, RANKING_MODE_ALL), ranking,
+                     (uint32_t)sizeof(*ranking));
+    case RANK_OP_PLACE:
+        return reply(fd, RANK_STATUS_OK, ranking_place_of(ranking, mode, req->score), ranking_total_runs(ranking, mode),
+                     NULL, 0);
+    case RANK_OP_PLAYER: {
+        PlayerStats stats;
+        if (!ranking_player_stats(req->name, &stats)) return reply(fd, RANK_STATUS_UNKNOWN, 0, 0, NULL, 0);
+        return reply(fd, RANK_STATUS_OK, 0, 0, &stats, (uint32_t)sizeof(stats));
+    }
+    default:
+        reply(fd, RANK_STATUS_ERROR, 0, 0, NULL, 0);
+        return 0;
+    }
+}
+
+static int run_daemon(const char *socket_path, const char *file)
+{
+    static Ranking ranking;
+    static RankdClient clients[RANKD_MAX_CLIENTS];
+    struct pollfd fds[RANKD_MAX_CLIENTS + 1];
+
+    int listen_fd = rankproto_listen(socket_path);
+    if (listen_fd < 0) {
+        fprintf(stderr, "rankd: nao foi possivel abrir %s (outro rankd no ar?)\n", socket_path);
+        return 1;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);       // cliente que some no meio da resposta vira erro no send
+
+    ranking_load(&ranking, file);
+    ranking_writer_start(&ranking, file);
+    printf("rankd: %s com %u partidas, socket %s\n", file, ranking_total_runs(&ranking, RANKING_MODE_ALL), socket_path);
+    fflush(stdout);
+
+    for (int i = 0; i < RANKD_MAX_CLIENTS; ++i) clients[i].fd = -1;
+    long long served = 0;
+
+    while (!stop_requested) {
+        int n = 0;
+        fds[n].fd = listen_fd;
+        fds[n].events = POLLIN;
+        n++;
+        for (int i = 0; i < RANKD_MAX_CLIENTS; ++i) {
+            fds[n].fd = clients[i].fd;      // fd negativo: o poll ignora
+            fds[n].events = POLLIN;
+            fds[n].revents = 0;
+            n++;
+        }
+        if (poll(fds, (nfds_t)n, RANKD_POLL_MS) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listen_fd, NULL, NULL);
+            int slot = -1;
+            for (int i = 0; fd >= 0 && i < RANKD_MAX_CLIENTS && slot < 0; ++i) {
+                if (clients[i].fd < 0) slot = i;
+            }
+            if (slot >= 0) {
+                clients[slot].fd = fd;
+                clients[slot].have = 0;
+            } else if (fd >= 0) {
+                rankproto_close(fd);        // cheio: o cliente cai para o arquivo
+            }
+        }
+
+        for (int i = 0; i < RANKD_MAX_CLIENTS; ++i) {
+            RankdClient *c = &clients[i];
+            if (c->fd < 0 || !(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+
+            // Só o que já chegou: um cliente lento não segura os outros
+            ssize_t got = recv(c->fd, (char *)&c->req + c->have, sizeof(c->req) - (size_t)c->have, 0);
+            int keep = got > 0;
+            if (keep) {
+                c->have += (int)got;
+                if (c->have == (int)sizeof(c->req)) {
+                    c->have = 0;
+                    keep = handle(c->fd, &c->req, &ranking, file);
+                    served++;
+                }
+            }
+            if (!keep) {
+                rankproto_close(c->fd);
+                c->fd = -1;
+            }
+        }
+    }
+
+    for (int i = 0; i < RANKD_MAX_CLIENTS; ++i) rankproto_close(clients[i].fd);
+    rankproto_close(listen_fd);
+    unlink(socket_path);
+    ranking_writer_stop();
+    printf("rankd: encerrado, %lld pedidos atendidos, %u partidas\n", served, ranking_total_runs(&ranking, RANKING_MODE_ALL));
+    return 0;
+}
+
+/* -------------------------------------------------------
+   CARGA (--bench)
+ ------------------------------------------------------- */
+typedef struct BenchClient {
+    UtilsThread thread;
+    const char *socket_path;
+    int id;
+    long inserts;
+    long done;
+    double worst_ms;
+} BenchClient;
+
+static void bench_main(void *arg)
+{
+    BenchClient *b = (BenchClient *)arg;
+    int fd = rankproto_connect(b->socket_path);
+    if (fd < 0) return;
+
+    RankRequest req;
+    memset(&req, 0, sizeof(req));
+    req.version = RANKPROTO_VERSION;
+    req.op = RANK_OP_ADD;
+    snprintf(req.name, sizeof(req.name), "bench%02d", b->id);
+
+    unsigned rng = 0x9E3779B9u ^ (unsigned)b->id;
+    for (long i = 0; i < b->inserts; ++i) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        req.score = (int32_t)(rng % 3000);
+        RankReply r;
+        double start = utils_now_seconds();
+        if (!rankproto_send(fd, &req, (int)sizeof(req)) || !rankproto_recv(fd, &r, (int)sizeof(r)) ||
+            r.status != RANK_STATUS_OK) {
+            break;
+        }
+        double ms = (utils_now_seconds() - start) * 1000.0;
+        if (ms > b->worst_ms) b->worst_ms = ms;
+        b->done++;
+    }
+    rankproto_close(fd);
+}
+
+static int run_bench(const char *socket_path, long inserts, int client_count)
+{
+    static BenchClient clients[RANKD_BENCH_MAX_CLIENTS];
+    if (client_count < 1) client_count = 1;
+    if (client_count > RANKD_BENCH_MAX_CLIENTS) client_count = RANKD_BENCH_MAX_CLIENTS;
+
+    int probe = rankproto_connect(socket_path);
+    if (probe < 0) {
+        fprintf(stderr, "rankd: nenhum daemon em %s\n", socket_path);
+        return 1;
+    }
+    rankproto_close(probe);
+
+    double start = utils_now_seconds();
+    for (int i = 0; i < client_count; ++i) {
+        clients[i].socket_path = socket_path;
+        clients[i].id = i;
+        clients[i].inserts = inserts;
+        utils_thread_start(&clients[i].thread, bench_main, &clients[i]);
+    }
+    long done = 0;
+    double worst = 0.0;
+    for (int i = 0; i < client_count; ++i) {
+        utils_thread_join(&clients[i].thread);
+        done += clients[i].done;
+        if (clients[i].worst_ms > worst) worst = clients[i].worst_ms;
+    }
+    double elapsed = utils_now_seconds() - start;
+
+    printf("rankd bench: %d clientes, %ld insercoes em %.2f s\n", client_count, done, elapsed);
+    printf("  %.0f insercoes/s, ida e volta %.1f us em media, %.2f ms no pior caso\n",
+           elapsed > 0.0 ? done / elapsed : 0.0, done > 0 ? elapsed * 1e6 * client_count / done : 0.0, worst);
+    return done == inserts * client_count ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    const char *socket_path = rankproto_socket_path();
+    const char *file = "ranking.txt";
+    long bench = 0;
+    int clients = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (strcmp(argv[i], "--file") == 0 && i + 1 < argc) {
+            file = argv[++i];
+        } else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+            bench = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--clients") == 0 && i + 1 < argc) {
+            clients = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "uso: %s [--socket CAMINHO] [--file ARQ] | --bench N [--clients K] [--socket CAMINHO]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (bench > 0) return run_bench(socket_path, bench, clients);
+
+    trace_start(getenv("CROSSY_TRACE"));
+    int rc = run_daemon(socket_path, file);
+    trace_stop();
+    return rc;
+}
@@ -1,6 +1,14 @@
 #include "ranking.h"
+#include "board.h"
+#include "mem.h"
+#include "names.h"
+#include "rankproto.h"
+#include "trace.h"
+#include "utils.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 static void safe_strcpy(char *dst, const char *src, int maxlen) {
     if (maxlen <= 0) return;
@@ -12,66 +20,964 @@ static void safe_strcpy(char *dst, const char *src, int maxlen) {
     dst[maxlen] = '\0';
 }
 
-// Função principal: adiciona pontuação, ordena com insertion sort e salva automaticamente
-void ranking_add(Ranking *ranking, const char *name, int score, const char *filepath) {
-    if (!ranking) return;
-    
-    // Adiciona nova pontuação
-    if (ranking->count < MAX_SCORES) {
-        safe_strcpy(ranking->items[ranking->count].name, name ? name : "Player", MAX_NAME_LEN);
-        ranking->items[ranking->count].score = score;
-        ranking->count++;
+/* -------------------------------------------------------
+   TOP-K POR MODO (MIN-HEAP)
+   - heap[0] é a pior das K: pontuação que não passa dela é
+     recusada com uma comparação, sem mexer no heap.
+   - Entrar no top-K: troca a raiz e desce, O(log K).
+   - Ordem de exibição (ranking_top) só quando alguém pede.
+ ------------------------------------------------------- */
+static RankingBoard *mode_board(Ranking *ranking, RankingMode mode) {
+    return &ranking->modes[mode >= 0 && mode < RANKING_MODE_COUNT ? mode : RANKING_MODE_SOLO];
+}
+
+// a sai do top-K antes de b: pontuação menor; no empate, a que chegou depois
+static int heap_worse(const ScoreEntry *a, const ScoreEntry *b) {
+    if (a->score != b->score) return a->score < b->score;
+    return a->order > b->order;
+}
+
+static void heap_swap(ScoreEntry *heap, int a, int b) {
+    ScoreEntry t = heap[a];
+    heap[a] = heap[b];
+    heap[b] = t;
+}
+
+static void heap_sift_up(ScoreEntry *heap, int i) {
+    while (i > 0 && heap_worse(&heap[i], &heap[(i - 1) / 2])) {
+        heap_swap(heap, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+static void heap_sift_down(ScoreEntry *heap, int count, int i) {
+    for (;;) {
+        int worst = i, l = 2 * i + 1, r = l + 1;
+        if (l < count && heap_worse(&heap[l], &heap[worst])) worst = l;
+        if (r < count && heap_worse(&heap[r], &heap[worst])) worst = r;
+        if (worst == i) return;
+        heap_swap(heap, i, worst);
+        i = worst;
+    }
+}
+
+// Retorna 1 se a pontuação entrou no top-K
+static int top_insert(RankingBoard *board, const char *name, int score) {
+    uint32_t order = board->arrivals++;
+    // Caso comum ao carregar milhões de partidas: cheio e não passa da pior (empate perde: chegou depois)
+    if (board->count == MAX_SCORES && score <= board->heap[0].score) return 0;
+
+    ScoreEntry e;
+    safe_strcpy(e.name, name, MAX_NAME_LEN);
+    e.score = score;
+    e.order = order;
+    if (board->count < MAX_SCORES) {
+        board->heap[board->count] = e;
+        heap_sift_up(board->heap, board->count++);
     } else {
-        // Substitui o pior se a nova pontuação for melhor
-        int worst_index = ranking->count - 1;
-        if (score > ranking->items[worst_index].score) {
-            safe_strcpy(ranking->items[worst_index].name, name ? name : "Player", MAX_NAME_LEN);
-            ranking->items[worst_index].score = score;
+        board->heap[0] = e;             // a pior sai
+        heap_sift_down(board->heap, board->count, 0);
+    }
+    return 1;
+}
+
+static int compare_top(const void *a, const void *b) {
+    const ScoreEntry *x = (const ScoreEntry *)a;
+    const ScoreEntry *y = (const ScoreEntry *)b;
+    return heap_worse(y, x) ? -1 : heap_worse(x, y) ? 1 : 0;
+}
+
+/* -------------------------------------------------------
+   HISTOGRAMA DE PONTUAÇÕES (FENWICK)
+   - tree[i] soma os baldes (i - lowbit(i), i]; balde = pontuação.
+ ------------------------------------------------------- */
+static int score_bucket(int score) {
+    if (score < 0) return 0;
+    return score < RANKING_SCORE_BUCKETS ? score : RANKING_SCORE_BUCKETS - 1;
+}
+
+static void histogram_add(ScoreHistogram *h, int score) {
+    for (int i = score_bucket(score) + 1; i <= RANKING_SCORE_BUCKETS; i += i & -i) h->tree[i]++;
+    h->total++;
+}
+
+// Partidas nos baldes 0..bucket
+static uint32_t histogram_prefix(const ScoreHistogram *h, int bucket) {
+    uint32_t sum = 0;
+    for (int i = bucket + 1; i > 0; i -= i & -i) sum += h->tree[i];
+    return sum;
+}
+
+// Monta a árvore a partir das contagens por balde em O(RANKING_SCORE_BUCKETS)
+static void histogram_build(ScoreHistogram *h, const uint32_t *counts) {
+    h->total = 0;
+    for (int i = 1; i <= RANKING_SCORE_BUCKETS; ++i) {
+        h->tree[i] = counts[i - 1];
+        h->total += counts[i - 1];
+    }
+    for (int i = 1; i <= RANKING_SCORE_BUCKETS; ++i) {
+        int parent = i + (i & -i);
+        if (parent <= RANKING_SCORE_BUCKETS) h->tree[parent] += h->tree[i];
+    }
+}
+
+// Toda partida passa por aqui: top-K + histograma do modo
+static void record_score(Ranking *ranking, RankingMode mode, const char *name, int score) {
+    RankingBoard *board = mode_board(ranking, mode);
+    top_insert(board, name, score);
+    histogram_add(&board->histogram, score);
+}
+
+/* -------------------------------------------------------
+   ARQUIVO
+   - Todas as partidas vão para o placar em disco (board.c):
+     ranking.dat + ranking.idx ao lado do ranking.txt.
+   - O Ranking é só a visão das MAX_SCORES melhores de cada modo.
+   - ranking.txt ("nome;pontos" por linha) é o formato antigo:
+     só é lido, para importar quando o placar ainda não existe.
+ ------------------------------------------------------- */
+static int board_exists(const char *filepath) {
+    char base[BOARD_PATH_LEN], dat[BOARD_PATH_LEN + 8];
+    board_base_path(base, sizeof(base), filepath);
+    snprintf(dat, sizeof(dat), "%s.dat", base);
+    FILE *f = fopen(dat, "rb");
+    if (!f) return 0;
+    fclose(f);
+    return 1;
+}
+
+static int open_board(Board *board, const char *filepath) {
+    char base[BOARD_PATH_LEN];
+    board_base_path(base, sizeof(base), filepath);
+    return board_open(board, base);
+}
+
+static void names_file(char *out, int size, const char *filepath) {
+    char base[BOARD_PATH_LEN];
+    board_base_path(base, sizeof(base), filepath);
+    names_path(out, size, base);
+}
+
+static BoardRecord make_record(uint32_t name, RankingMode mode, uint32_t seed, int score) {
+    BoardRecord r;
+    memset(&r, 0, sizeof(r));
+    r.score = score;
+    r.time = (uint32_t)time(NULL);
+    r.seed = seed;
+    r.mode = (uint16_t)(mode >= 0 && mode < RANKING_MODE_COUNT ? mode : RANKING_MODE_SOLO);
+    r.name = name;
+    return r;
+}
+
+/* -------------------------------------------------------
+   JOGADORES
+   - Nomes internados (names.h): cada nome existe uma vez, na
+     memória e no disco; os registros do placar guardam o id.
+   - players[id]: recorde, partidas, soma e as últimas
+     RANKING_RECENT pontuações do jogador, O(1) por id.
+   - Dono: a thread que chama ranking_load/ranking_add
+     (render). A thread de escrita só recebe os ids prontos.
+ ------------------------------------------------------- */
+typedef struct PlayerEntry {
+    int best;
+    uint32_t runs;
+    long long sum;
+    int recent[RANKING_RECENT];     // recent[0] = a mais recente (pela hora da partida)
+    uint32_t recent_time[RANKING_RECENT];
+    int recent_count;
+} PlayerEntry;
+
+static NameTable names;
+static PlayerEntry *players = NULL;
+static uint32_t players_cap = 0;
+static char players_file[BOARD_PATH_LEN];   // ranking a que names/players se referem ("" = nenhum)
+
+static void players_reset(const char *filepath) {
+    names_free(&names);
+    if (players) mem_free(MEM_RANKING, players, players_cap * sizeof(PlayerEntry));
+    players = NULL;
+    players_cap = 0;
+    safe_strcpy(players_file, filepath ? filepath : "", (int)sizeof(players_file) - 1);
+}
+
+// when: hora da partida. As recentes saem dela, não da ordem do .dat (num placar juntado, o
+// .dat está na ordem do placar); hora igual: a que chegou depois é a mais recente
+static void player_record(uint32_t id, int score, uint32_t when) {
+    if (id >= names.count) return;              // nome perdido num crash: só o placar conta
+    if (id >= players_cap) {
+        uint32_t cap = players_cap ? players_cap : 64;
+        while (cap <= id) cap *= 2;
+        PlayerEntry *grown = (PlayerEntry *)mem_alloc(MEM_RANKING, cap * sizeof(PlayerEntry));
+        if (!grown) return;
+        memset(grown, 0, cap * sizeof(PlayerEntry));
+        if (players) {
+            memcpy(grown, players, players_cap * sizeof(PlayerEntry));
+            mem_free(MEM_RANKING, players, players_cap * sizeof(PlayerEntry));
+        }
+        players = grown;
+        players_cap = cap;
+    }
+    PlayerEntry *p = &players[id];
+    if (p->runs == 0 || score > p->best) p->best = score;
+    p->runs++;
+    p->sum += score;
+    int at = 0;
+    while (at < p->recent_count && p->recent_time[at] > when) at++;
+    if (at == RANKING_RECENT) return;           // mais antiga que todas as guardadas
+    int last = p->recent_count < RANKING_RECENT ? p->recent_count++ : RANKING_RECENT - 1;
+    for (int i = last; i > at; --i) {
+        p->recent[i] = p->recent[i - 1];
+        p->recent_time[i] = p->recent_time[i - 1];
+    }
+    p->recent[at] = score;
+    p->recent_time[at] = when;
+}
+
+// Nome como vai para o arquivo: cortado em MAX_NAME_LEN e sem quebra de linha
+// len < 0: até o '\0'
+static void clean_name(char *out, const char *name, int len) {
+    if (!name) name = "Player";
+    if (len < 0 || len > MAX_NAME_LEN) len = MAX_NAME_LEN;
+    int i = 0;
+    for (; i < len && name[i]; ++i) out[i] = (name[i] == '\n' || name[i] == '\r') ? ' ' : name[i];
+    out[i] = '\0';
+}
+
+// Top-K e histograma de cada modo + índice por jogador: uma leitura sequencial dos registros
+static void load_board(Ranking *ranking, Board *board, const char *filepath) {
+    char path[BOARD_PATH_LEN + 8];
+    names_file(path, sizeof(path), filepath);
+    names_load(&names, path);
+
+    static uint32_t counts[RANKING_MODE_COUNT][RANKING_SCORE_BUCKETS];
+    memset(counts, 0, sizeof(counts));
+
+    // Na ordem do .dat. Desempate do top-K: dentro de uma pontuação o .dat tem a mais antiga
+    // primeiro, tanto gravado pelo jogo quanto juntado (board_build_*); as recentes usam a hora
+    static BoardRecord chunk[1024];
+    uint32_t first = 0;
+    int got;
+    while ((got = board_read_records(board, first, chunk, 1024)) > 0) {
+        for (int i = 0; i < got; ++i) {
+            const BoardRecord *r = &chunk[i];
+            RankingMode mode = r->mode < RANKING_MODE_COUNT ? (RankingMode)r->mode : RANKING_MODE_SOLO;
+            top_insert(&ranking->modes[mode], names_get(&names, r->name), r->score);
+            counts[mode][score_bucket(r->score)]++;
+            player_record(r->name, r->score, r->time);
         }
+        first += (uint32_t)got;
+    }
+    for (int m = 0; m < RANKING_MODE_COUNT; ++m) histogram_build(&ranking->modes[m].histogram, counts[m]);
+}
+
+/* -------------------------------------------------------
+   RANKING.TXT (FORMATO ANTIGO)
+   - O arquivo inteiro é mapeado e lido por um scanner feito
+     à mão: memchr acha o fim da linha, sem fgets/sscanf.
+   - Uma passada monta top-K, histograma e jogadores.
+   - Linha ruim não para a leitura: é contada no relatório.
+ ------------------------------------------------------- */
+static RankingLoadReport last_report;
+
+static int is_blank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+// "  -123  " -> -123; qualquer outra coisa (vazio, lixo, estouro de int) é erro
+static int parse_score(const char *p, const char *end, int *out) {
+    while (p < end && is_blank(*p)) p++;
+    while (end > p && is_blank(end[-1])) end--;
+    int negative = 0;
+    if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+    if (p == end) return 0;
+    long long value = 0;
+    for (; p < end; ++p) {
+        if (*p < '0' || *p > '9') return 0;
+        value = value * 10 + (*p - '0');
+        if (value > 2147483648LL) return 0;
     }
-    
-    // Insertion Sort (ordena decrescente por pontuação, alfabético em empate)
-    for (int i = 1; i < ranking->count; ++i) {
-        ScoreEntry key = ranking->items[i];
-        int j = i - 1;
-        while (j >= 0) {
-            int swap = 0;
-            if (ranking->items[j].score < key.score) {
-                swap = 1;
-            } else if (ranking->items[j].score == key.score) {
-                if (strcmp(ranking->items[j].name, key.name) > 0) swap = 1;
+    if (negative) value = -value;
+    if (value > 2147483647LL) return 0;
+    *out = (int)value;
+    return 1;
+}
+
+static void report_bad_line(RankingLoadReport *report, uint32_t line) {
+    if (report->malformed < RANKING_REPORT_BAD_LINES) report->bad_lines[report->malformed] = line;
+    report->malformed++;
+}
+
+int ranking_scan_text(const char *filepath, RankingLineFn fn, void *ctx, RankingLoadReport *report) {
+    static RankingLoadReport scratch;
+    if (!report) report = &scratch;
+    UtilsMapping map;
+    if (!filepath || !fn || !utils_map_file(filepath, &map)) return 0;
+
+    const char *p = (const char *)map.data;
+    const char *end = p ? p + map.size : p;
+    while (p < end) {
+        const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+        if (!nl) {
+            report->torn_tail = 1;              // escrita cortada: a linha não conta
+            break;
+        }
+        uint32_t line = ++report->lines;
+        const char *line_end = nl;
+        if (line_end > p && line_end[-1] == '\r') line_end--;
+
+        if (line_end > p) {                     // linha vazia: ignora
+            const char *semi = (const char *)memchr(p, ';', (size_t)(line_end - p));
+            int score;
+            if (!semi || semi == p || !parse_score(semi + 1, line_end, &score)) {
+                report_bad_line(report, line);
+            } else {
+                char name[MAX_NAME_LEN + 1];
+                clean_name(name, p, (int)(semi - p < MAX_NAME_LEN ? semi - p : MAX_NAME_LEN));
+                fn(ctx, name, score);
+                report->loaded++;
             }
-            if (!swap) break;
-            ranking->items[j + 1] = ranking->items[j];
-            j--;
         }
-        ranking->items[j + 1] = key;
-    }
-    
-    // Salva automaticamente no arquivo
-    if (filepath) {
-        FILE *f = fopen(filepath, "w");
-        if (f) {
-            for (int i = 0; i < ranking->count; ++i) {
-                fprintf(f, "%s;%d\n", ranking->items[i].name, ranking->items[i].score);
+        p = nl + 1;
+    }
+    utils_unmap_file(&map);
+    return 1;
+}
+
+typedef struct TextLoad {
+    Ranking *ranking;
+    uint32_t *counts;
+} TextLoad;
+
+// ranking.txt antigo não tinha modos: tudo conta como 1 jogador
+static void load_text_line(void *ctx, const char *name, int score) {
+    TextLoad *load = (TextLoad *)ctx;
+    top_insert(&load->ranking->modes[RANKING_MODE_SOLO], name, score);
+    load->counts[score_bucket(score)]++;
+    player_record(names_intern(&names, name, NULL), score, 0);   // sem hora: fica a ordem do arquivo
+}
+
+static void load_text(Ranking *ranking, const char *filepath) {
+    static uint32_t counts[RANKING_SCORE_BUCKETS];
+    memset(counts, 0, sizeof(counts));
+    TextLoad load = { ranking, counts };
+    if (ranking_scan_text(filepath, load_text_line, &load, &last_report)) {
+        histogram_build(&ranking->modes[RANKING_MODE_SOLO].histogram, counts);
+    }
+}
+
+/* -------------------------------------------------------
+   THREAD DE ESCRITA
+   - ranking_add (render) só põe a pontuação numa fila SPSC
+     sem locks; nenhum acesso a disco no frame do game over.
+   - A thread acorda a cada RANKING_WRITER_MS (1 ms sob carga),
+     grava no placar tudo o que chegou (rajadas viram um lote)
+     e faz no máximo um fsync a cada RANKING_FSYNC_SECONDS.
+   - Ela mantém a própria cópia dos top-K (mesmas inserções),
+     devolvida pelo ranking_load sem reler o disco.
+ ------------------------------------------------------- */
+#define RANKING_QUEUE_CAPACITY 1024    // potência de 2 (o rankd recebe milhares por segundo)
+#define RANKING_WRITER_MS 50
+#define RANKING_FSYNC_SECONDS 2.0
+
+typedef struct PendingScore {
+    char name[MAX_NAME_LEN + 1];    // para o top-K da cópia
+    int score;
+    RankingMode mode;
+    uint32_t seed;
+    uint32_t name_id;
+    int new_name;                   // 1 = primeiro registro do nome: acrescenta no .names antes
+} PendingScore;
+
+static PendingScore writer_queue[RANKING_QUEUE_CAPACITY];
+static unsigned writer_head = 0;        // atômico: escrito pelo render
+static unsigned writer_tail = 0;        // atômico: escrito pela thread de escrita
+static int writer_running = 0;          // atômico
+static int writer_started = 0;
+static UtilsThread writer_thread;
+static char writer_path[BOARD_PATH_LEN];
+static Ranking writer_mirror;
+static Board writer_board;
+static FILE *writer_names = NULL;       // <base>.names aberto para acréscimo
+static int writer_dirty = 0;            // escrito desde o último fsync
+static double writer_last_fsync = 0.0;
+
+// Retorna quantas pontuações gravou
+static unsigned writer_flush(int force_sync) {
+    unsigned tail = writer_tail;
+    unsigned head = __atomic_load_n(&writer_head, __ATOMIC_ACQUIRE);
+    unsigned drained = head - tail;
+
+    if (tail != head) {
+        TRACE_BEGIN("ranking_write");
+        while (tail != head) {
+            const PendingScore *p = &writer_queue[tail & (RANKING_QUEUE_CAPACITY - 1)];
+            BoardRecord r = make_record(p->name_id, p->mode, p->seed, p->score);
+            record_score(&writer_mirror, p->mode, p->name, p->score);
+            if (p->new_name) names_write(writer_names, p->name);    // nome antes do registro que o usa
+            board_add(&writer_board, &r);
+            tail++;
+        }
+        TRACE_END("ranking_write");
+        writer_dirty = 1;
+        __atomic_store_n(&writer_tail, tail, __ATOMIC_RELEASE);
+    }
+
+    double now = utils_now_seconds();
+    if (writer_dirty && (force_sync || now - writer_last_fsync >= RANKING_FSYNC_SECONDS)) {
+        if (writer_names) utils_fsync_file(writer_names);
+        board_sync(&writer_board);
+        writer_last_fsync = now;
+        writer_dirty = 0;
+    }
+    return drained;
+}
+
+static void writer_main(void *arg) {
+    (void)arg;
+    trace_thread_name("ranking_writer");
+    while (__atomic_load_n(&writer_running, __ATOMIC_ACQUIRE)) {
+        // Sob carga (rankd) volta logo: a fila não pode encher esperando os 50 ms
+        unsigned drained = writer_flush(0);
+        utils_sleep_ms(drained > 0 ? 1 : RANKING_WRITER_MS);
+    }
+    writer_flush(1);                    // o que chegou até o stop vai para o disco
+    board_close(&writer_board);
+    if (writer_names) fclose(writer_names);
+    writer_names = NULL;
+    trace_thread_exit();
+}
+
+static int writer_owns(const char *filepath) {
+    return filepath && __atomic_load_n(&writer_running, __ATOMIC_ACQUIRE) && strcmp(filepath, writer_path) == 0;
+}
+
+// Espera a thread de escrita gravar tudo o que já foi enfileirado
+static void writer_wait_drained(void) {
+    while (__atomic_load_n(&writer_tail, __ATOMIC_ACQUIRE) != writer_head) utils_sleep_ms(1);
+}
+
+// Placar que recebe o ranking.txt: os registros e os nomes que eles usam
+typedef struct TextImport {
+    Board *board;
+    NameTable *names;
+    FILE *names_out;                // .names aberto para acréscimo
+} TextImport;
+
+// Cada linha do ranking.txt vira uma partida de 1 jogador no placar novo
+static void import_text_line(void *ctx, const char *name, int score) {
+    TextImport *import = (TextImport *)ctx;
+    int created;
+    uint32_t id = names_intern(import->names, name, &created);
+    if (id == NAMES_NONE || (created && !names_write(import->names_out, name))) return;
+    BoardRecord r = make_record(id, RANKING_MODE_SOLO, 0, score);
+    r.time = 0;                         // a linha não diz quando foi jogada
+    board_add(import->board, &r);
+}
+
+// Placar vazio: importa o ranking.txt inteiro (todas as linhas, não só o top-K), na ordem dele
+static void import_text(Board *board, NameTable *table, FILE *names_out, const char *filepath) {
+    if (board_count(board) > 0) return;
+    TextImport import = { board, table, names_out };
+    ranking_scan_text(filepath, import_text_line, &import, NULL);
+    board_sync(board);
+}
+
+/* -------------------------------------------------------
+   GRAVAÇÃO DIRETA (SEM THREAD DE ESCRITA)
+   - Quando a thread não é dona do arquivo (não subiu, ou o
+     rankd caiu no meio), ranking_add grava no próprio frame.
+   - O placar de destino fica aberto entre as chamadas, com a
+     própria tabela de nomes: os nomes/jogadores do ranking
+     carregado (names/players) nunca trocam de arquivo.
+   - Fecha (fsync) ao trocar de arquivo, no ranking_load dele,
+     no ranking_writer_start e no atexit.
+ ------------------------------------------------------- */
+static char direct_path[BOARD_PATH_LEN];   // "" = nenhum
+static Board direct_board;
+static NameTable direct_names;
+static FILE *direct_names_out = NULL;
+
+// filepath NULL: fecha qualquer um; senão só se for esse
+static void direct_close(const char *filepath) {
+    if (!direct_path[0] || (filepath && strcmp(filepath, direct_path) != 0)) return;
+    board_sync(&direct_board);
+    board_close(&direct_board);
+    if (direct_names_out) fclose(direct_names_out);
+    direct_names_out = NULL;
+    names_free(&direct_names);
+    direct_path[0] = '\0';
+}
+
+static void direct_close_all(void) {
+    direct_close(NULL);
+}
+
+static int direct_open(const char *filepath) {
+    if (strcmp(direct_path, filepath) == 0) return 1;
+    if (strlen(filepath) >= sizeof(direct_path)) return 0;
+    direct_close(NULL);
+
+    char path[BOARD_PATH_LEN + 8];
+    names_file(path, sizeof(path), filepath);
+    names_init(&direct_names);
+    names_load(&direct_names, path);
+    direct_names_out = names_open(&direct_names, path);
+    if (!direct_names_out || !open_board(&direct_board, filepath)) {
+        if (direct_names_out) fclose(direct_names_out);
+        direct_names_out = NULL;
+        names_free(&direct_names);
+        return 0;
+    }
+    import_text(&direct_board, &direct_names, direct_names_out, filepath);
+    strcpy(direct_path, filepath);
+
+    static int exit_hook = 0;
+    if (!exit_hook) {
+        atexit(direct_close_all);
+        exit_hook = 1;
+    }
+    return 1;
+}
+
+// Retorna 0 em erro de escrita
+static int direct_add(const char *filepath, RankingMode mode, uint32_t seed, const char *name, int score) {
+    if (!direct_open(filepath)) return 0;
+    int created;
+    uint32_t id = names_intern(&direct_names, name, &created);
+    if (id == NAMES_NONE || (created && !names_write(direct_names_out, name))) return 0;     // nome antes do registro
+    BoardRecord r = make_record(id, mode, seed, score);
+    return board_add(&direct_board, &r);
+}
+
+int ranking_writer_start(const Ranking *ranking, const char *filepath) {
+    if (!ranking || !filepath || writer_started) return 0;
+    if (strlen(filepath) >= sizeof(writer_path)) return 0;
+    if (strcmp(players_file, filepath) != 0) return 0;      // ranking_load desse arquivo antes
+    direct_close(filepath);             // dois Board no mesmo arquivo se atropelam
+    if (!open_board(&writer_board, filepath)) return 0;
+
+    // Nomes já carregados (ou vindos do ranking.txt) vão para o arquivo antes de qualquer registro
+    char path[BOARD_PATH_LEN + 8];
+    names_file(path, sizeof(path), filepath);
+    writer_names = names_open(&names, path);
+    if (!writer_names) {
+        board_close(&writer_board);
+        return 0;
+    }
+
+    import_text(&writer_board, &names, writer_names, filepath);   // primeira vez com placar
+
+    strcpy(writer_path, filepath);
+    writer_mirror = *ranking;
+    writer_head = writer_tail = 0;
+    writer_dirty = 0;
+    writer_last_fsync = utils_now_seconds();
+
+    __atomic_store_n(&writer_running, 1, __ATOMIC_RELEASE);
+    if (!utils_thread_start(&writer_thread, writer_main, NULL)) {
+        writer_running = 0;             // sem thread: ranking_add escreve direto
+        board_close(&writer_board);
+        fclose(writer_names);
+        writer_names = NULL;
+        return 0;
+    }
+    writer_started = 1;
+
+    static int exit_hook = 0;
+    if (!exit_hook) {
+        atexit(ranking_writer_stop);    // exit() em qualquer lugar ainda grava o que estava na fila
+        exit_hook = 1;
+    }
+    return 1;
+}
+
+void ranking_writer_stop(void) {
+    if (!writer_started) return;
+    __atomic_store_n(&writer_running, 0, __ATOMIC_RELEASE);
+    utils_thread_join(&writer_thread);
+    writer_started = 0;
+}
+
+/* -------------------------------------------------------
+   SERVIÇO COMPARTILHADO (rankd)
+   - Com o daemon no ar, inserções e consultas vão pelo socket
+     e ele é o único que escreve o placar: processos no mesmo
+     host não se atropelam mais no arquivo.
+   - Qualquer erro no socket desconecta e o jogo volta para o
+     arquivo (ranking_add grava direto, sem thread de escrita).
+ ------------------------------------------------------- */
+static int service_fd = -1;
+
+int ranking_service_connect(const char *socket_path) {
+    if (service_fd >= 0) return 1;
+    service_fd = rankproto_connect(socket_path ? socket_path : rankproto_socket_path());
+    return service_fd >= 0;
+}
+
+void ranking_service_disconnect(void) {
+    rankproto_close(service_fd);
+    service_fd = -1;
+}
+
+int ranking_service_active(void) {
+    return service_fd >= 0;
+}
+
+/**
+ * Uma ida e volta com o daemon
+ * @param payload Recebe reply->size bytes (precisa ser exatamente payload_size); NULL = sem payload
+ * @return 0 em erro (e desconecta)
+ */
+static int service_call(RankOp op, RankingMode mode, uint32_t seed, const char *name, int score, RankReply *reply,
+                        void *payload, int payload_size) {
+    if (service_fd < 0) return 0;
+    RankRequest req;
+    memset(&req, 0, sizeof(req));
+    req.version = RANKPROTO_VERSION;
+    req.op = (uint32_t)op;
+    req.mode = (int32_t)mode;
+    req.seed = seed;
+    req.score = score;
+    if (name) clean_name(req.name, name, -1);
+
+    int ok = rankproto_send(service_fd, &req, (int)sizeof(req)) &&
+             rankproto_recv(service_fd, reply, (int)sizeof(*reply)) &&
+             reply->status != RANK_STATUS_ERROR;
+    if (ok && reply->size > 0) {
+        ok = payload && reply->size == (uint32_t)payload_size && rankproto_recv(service_fd, payload, payload_size);
+    }
+    if (!ok) ranking_service_disconnect();
+    return ok;
+}
+
+/* -------------------------------------------------------
+   TELA DE RANKING (PLACAR COMPLETO)
+   - O placar é aberto só para leitura: a linha k sai do índice
+     mapeado (cursor posicionado em O(log n)) + o registro dela.
+   - Busca: ids dos nomes ordenados alfabeticamente; um prefixo
+     é uma faixa contígua (duas buscas binárias).
+   - Um modo (ou sem placar, só ranking.txt): as linhas são as
+     do top-K do modo, ordenado uma vez na abertura.
+ ------------------------------------------------------- */
+#define RANKING_VIEW_TIE_SCAN 4096     // linhas empatadas lidas para achar um jogador
+
+static Board view_board;                // grande (cauda): fora da pilha
+static int view_has_board = 0;
+static ScoreEntry view_top[MAX_SCORES]; // sem placar: o top-K em ordem
+static int view_top_count = 0;
+static NameTable view_names;
+static uint32_t *view_sorted = NULL;    // ids de view_names em ordem alfabética
+static uint32_t view_sorted_cap = 0;
+
+static int compare_view_names(const void *a, const void *b) {
+    return strcmp(names_get(&view_names, *(const uint32_t *)a), names_get(&view_names, *(const uint32_t *)b));
+}
+
+// Primeiro id (na ordem alfabética) cujo nome não vem antes de prefix; upper = primeiro depois da faixa
+static uint32_t view_prefix_bound(const char *prefix, size_t len, int upper) {
+    uint32_t lo = 0, hi = view_names.count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        int c = strncmp(names_get(&view_names, view_sorted[mid]), prefix, len);
+        if (c < 0 || (upper && c == 0)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+void ranking_view_close(void) {
+    if (view_has_board) board_close(&view_board);
+    view_has_board = 0;
+    view_top_count = 0;
+    names_free(&view_names);
+    if (view_sorted) mem_free(MEM_RANKING, view_sorted, view_sorted_cap * sizeof(uint32_t));
+    view_sorted = NULL;
+    view_sorted_cap = 0;
+}
+
+uint32_t ranking_view_open(const Ranking *ranking, RankingMode mode, const char *filepath) {
+    ranking_view_close();
+    TRACE_BEGIN("ranking_view_open");
+
+    // O que está na fila ainda não está no arquivo
+    if (mode == RANKING_MODE_ALL && writer_owns(filepath)) writer_wait_drained();
+    if (mode == RANKING_MODE_ALL && filepath && board_exists(filepath)) {
+        char base[BOARD_PATH_LEN], path[BOARD_PATH_LEN + 8];
+        board_base_path(base, sizeof(base), filepath);
+        view_has_board = board_open_read(&view_board, base);
+        names_path(path, sizeof(path), base);
+        if (view_has_board) names_load(&view_names, path);
+    }
+    if (!view_has_board && ranking) {
+        view_top_count = ranking_top(ranking, mode == RANKING_MODE_ALL ? RANKING_MODE_SOLO : mode, view_top);
+        for (int i = 0; i < view_top_count; ++i) names_intern(&view_names, view_top[i].name, NULL);
+    }
+
+    view_sorted_cap = view_names.count ? view_names.count : 1;
+    view_sorted = (uint32_t *)mem_alloc(MEM_RANKING, view_sorted_cap * sizeof(uint32_t));
+    if (view_sorted) {
+        for (uint32_t id = 0; id < view_names.count; ++id) view_sorted[id] = id;
+        qsort(view_sorted, view_names.count, sizeof(uint32_t), compare_view_names);
+    }
+    TRACE_END("ranking_view_open");
+    return ranking_view_count();
+}
+
+uint32_t ranking_view_count(void) {
+    if (view_has_board) return board_count(&view_board);
+    return (uint32_t)view_top_count;
+}
+
+int ranking_view_rows(uint32_t first, RankingRow *out, int max) {
+    if (!out || max <= 0) return 0;
+    int n = 0;
+    if (view_has_board) {
+        BoardCursor cursor;
+        BoardEntry e;
+        board_cursor_seek(&view_board, &cursor, first);
+        while (n < max && board_cursor_next(&view_board, &cursor, &e)) {
+            BoardRecord r;
+            RankingRow *row = &out[n++];
+            row->score = e.score;
+            row->place = board_rank_of(&view_board, e.score) + 1;
+            clean_name(row->name, board_read_record(&view_board, e.record, &r) ? names_get(&view_names, r.name) : "?", -1);
+        }
+        return n;
+    }
+    for (uint32_t i = first; n < max && i < (uint32_t)view_top_count; ++i) {
+        RankingRow *row = &out[n++];
+        row->score = view_top[i].score;
+        row->place = ranking_view_row_of_score(row->score) + 1;
+        clean_name(row->name, view_top[i].name, -1);
+    }
+    return n;
+}
+
+uint32_t ranking_view_row_of_score(int score) {
+    if (view_has_board) return board_rank_of(&view_board, score);
+    uint32_t row = 0;
+    while (row < (uint32_t)view_top_count && view_top[row].score > score) row++;
+    return row;
+}
+
+uint32_t ranking_view_row_of_player(const char *name, int score) {
+    uint32_t row = ranking_view_row_of_score(score);
+    if (!name) return row;
+    if (!view_has_board) {
+        for (uint32_t i = row; i < (uint32_t)view_top_count && view_top[i].score == score; ++i) {
+            if (strcmp(view_top[i].name, name) == 0) return i;
+        }
+        return row;
+    }
+
+    // Empates: procura o registro do jogador, por id, nas primeiras RANKING_VIEW_TIE_SCAN linhas
+    uint32_t id = names_find(&view_names, name);
+    BoardCursor cursor;
+    BoardEntry e;
+    board_cursor_seek(&view_board, &cursor, row);
+    for (uint32_t i = row; id != NAMES_NONE && i < row + RANKING_VIEW_TIE_SCAN; ++i) {
+        BoardRecord r;
+        if (!board_cursor_next(&view_board, &cursor, &e) || e.score != score) break;
+        if (board_read_record(&view_board, e.record, &r) && r.name == id) return i;
+    }
+    return row;
+}
+
+int ranking_view_find(const char *prefix, RankingMatch *out, int max, uint32_t *total) {
+    if (total) *total = 0;
+    if (!prefix || !out || !view_sorted) return 0;
+    size_t len = strlen(prefix);
+    uint32_t first = view_prefix_bound(prefix, len, 0);
+    uint32_t last = view_prefix_bound(prefix, len, 1);
+    if (total) *total = last - first;
+
+    int n = 0;
+    for (uint32_t i = first; i < last && n < max; ++i) {
+        RankingMatch *m = &out[n++];
+        clean_name(m->name, names_get(&view_names, view_sorted[i]), -1);
+        PlayerStats stats;
+        m->runs = ranking_player_stats(m->name, &stats) ? stats.runs : 0;
+        m->best = m->runs ? stats.best : 0;
+        m->row = m->runs ? ranking_view_row_of_score(m->best) : 0;
+        // Um modo só: o recorde que conta é o melhor dele nesse top-K
+        for (int k = 0; !view_has_board && k < view_top_count; ++k) {
+            if (strcmp(view_top[k].name, m->name) == 0) {
+                m->best = view_top[k].score;
+                m->row = ranking_view_row_of_score(m->best);
+                break;
             }
-            fclose(f);
         }
     }
+    return n;
+}
+
+/* -------------------------------------------------------
+   API
+ ------------------------------------------------------- */
+// Adiciona pontuação: O(1) se não entra no top-K do modo, O(log K) se entra; o disco fica com a thread de escrita
+void ranking_add(Ranking *ranking, RankingMode mode, uint32_t seed, const char *name, int score, const char *filepath) {
+    if (!ranking) return;
+    if (mode < 0 || mode >= RANKING_MODE_COUNT) mode = RANKING_MODE_SOLO;
+    TRACE_BEGIN("ranking_add");
+    char clean[MAX_NAME_LEN + 1];
+    clean_name(clean, name, -1);
+
+    // Com o rankd, ele grava; aqui só a visão local acompanha
+    RankReply reply;
+    if (filepath && service_call(RANK_OP_ADD, mode, seed, name, score, &reply, NULL, 0)) {
+        record_score(ranking, mode, clean, score);
+        TRACE_END("ranking_add");
+        return;
+    }
+
+    // Toda partida vai para o placar, o histograma e o jogador, mesmo as que não entram no top-K
+    record_score(ranking, mode, clean, score);
+    int owned = writer_owns(filepath);
+    if (!owned && filepath) {
+        // Sem thread de escrita: grava direto; o resumo por jogador só acompanha o arquivo carregado
+        direct_add(filepath, mode, seed, clean, score);
+        if (strcmp(players_file, filepath) == 0) player_record(names_intern(&names, clean, NULL), score, (uint32_t)time(NULL));
+        TRACE_END("ranking_add");
+        return;
+    }
+
+    int created;
+    uint32_t id = names_intern(&names, clean, &created);
+    player_record(id, score, (uint32_t)time(NULL));
+    if (owned) {
+        unsigned head = writer_head;
+        // Fila cheia só com dezenas de game overs em 50 ms: espera a thread abrir espaço
+        while (head - __atomic_load_n(&writer_tail, __ATOMIC_ACQUIRE) >= RANKING_QUEUE_CAPACITY) utils_sleep_ms(1);
+        PendingScore *p = &writer_queue[head & (RANKING_QUEUE_CAPACITY - 1)];
+        memcpy(p->name, clean, sizeof(p->name));
+        p->score = score;
+        p->mode = mode;
+        p->seed = seed;
+        p->name_id = id;
+        p->new_name = created;
+        __atomic_store_n(&writer_head, head + 1, __ATOMIC_RELEASE);
+    }
+    TRACE_END("ranking_add");
 }
 
-// Carrega ranking do arquivo
+// Carrega os top-K: do placar em disco, ou do ranking.txt antigo se ainda não há placar
 void ranking_load(Ranking *ranking, const char *filepath) {
     if (!ranking) return;
-    ranking->count = 0;
-    FILE *f = fopen(filepath, "r");
-    if (!f) return;
-    char name[128];
-    int score;
-    while (ranking->count < MAX_SCORES && fscanf(f, "%127[^;];%d\n", name, &score) == 2) {
-        safe_strcpy(ranking->items[ranking->count].name, name, MAX_NAME_LEN);
-        ranking->items[ranking->count].score = score;
-        ranking->count++;
+    memset(ranking, 0, sizeof(*ranking));
+    memset(&last_report, 0, sizeof(last_report));
+    double start = utils_now_seconds();
+    direct_close(filepath);             // o que foi gravado direto já está no arquivo que vai ser lido
+
+    // Com o rankd: top-K + histogramas de todos os processos numa resposta só
+    RankReply reply;
+    if (filepath && service_call(RANK_OP_SNAPSHOT, RANKING_MODE_ALL, 0, NULL, 0, &reply, ranking, (int)sizeof(*ranking))) {
+        last_report.from_service = 1;
+        last_report.loaded = ranking_total_runs(ranking, RANKING_MODE_ALL);
+        last_report.ms = (utils_now_seconds() - start) * 1000.0;
+        return;
     }
-    fclose(f);
+    memset(ranking, 0, sizeof(*ranking));   // resposta incompleta pode ter sujado
+
+    // Nomes e jogadores já estão em dia: ranking_add atualiza os dois antes de enfileirar
+    if (writer_owns(filepath)) {
+        writer_wait_drained();
+        *ranking = writer_mirror;
+        last_report.loaded = ranking_total_runs(ranking, RANKING_MODE_ALL);
+        last_report.ms = (utils_now_seconds() - start) * 1000.0;
+        return;
+    }
+
+    TRACE_BEGIN("ranking_load");
+    players_reset(filepath);
+    if (filepath && board_exists(filepath)) {
+        static Board board;             // grande (cauda): fora da pilha
+        if (open_board(&board, filepath)) {
+            load_board(ranking, &board, filepath);
+            board_close(&board);
+            last_report.from_board = 1;
+            last_report.lines = last_report.loaded = ranking_total_runs(ranking, RANKING_MODE_ALL);
+        }
+    }
+    if (filepath && !last_report.from_board) load_text(ranking, filepath);
+    last_report.ms = (utils_now_seconds() - start) * 1000.0;
+    TRACE_END("ranking_load");
+}
+
+void ranking_load_report(RankingLoadReport *out) {
+    if (out) *out = last_report;
+}
+
+int ranking_player_stats(const char *name, PlayerStats *out) {
+    if (!name || !out) return 0;
+    RankReply reply;
+    if (service_fd >= 0) {
+        PlayerStats remote;
+        if (service_call(RANK_OP_PLAYER, RANKING_MODE_ALL, 0, name, 0, &reply, &remote, (int)sizeof(remote))) {
+            if (reply.status != RANK_STATUS_OK) return 0;
+            *out = remote;
+            return 1;
+        }
+    }
+    char clean[MAX_NAME_LEN + 1];
+    clean_name(clean, name, -1);
+    uint32_t id = names_find(&names, clean);
+    if (id == NAMES_NONE || id >= players_cap || players[id].runs == 0) return 0;
+
+    const PlayerEntry *p = &players[id];
+    out->best = p->best;
+    out->runs = p->runs;
+    out->mean = (double)p->sum / (double)p->runs;
+    out->recent_count = p->recent_count;
+    for (int i = 0; i < out->recent_count; ++i) {
+        out->recent[i] = p->recent[i];
+    }
+    return 1;
+}
+
+const char *ranking_mode_name(RankingMode mode) {
+    switch (mode) {
+    case RANKING_MODE_ALL: return "Todos";
+    case RANKING_MODE_SOLO: return "1 jogador";
+    case RANKING_MODE_DUO: return "2 jogadores";
+    case RANKING_MODE_DAILY: return "Desafio do dia";
+    default: return "?";
+    }
+}
+
+int ranking_top(const Ranking *ranking, RankingMode mode, ScoreEntry *out) {
+    if (!ranking || !out || mode < 0 || mode >= RANKING_MODE_COUNT) return 0;
+    const RankingBoard *board = &ranking->modes[mode];
+    memcpy(out, board->heap, (size_t)board->count * sizeof(ScoreEntry));
+    qsort(out, (size_t)board->count, sizeof(ScoreEntry), compare_top);
+    return board->count;
+}
+
+uint32_t ranking_total_runs(const Ranking *ranking, RankingMode mode) {
+    if (!ranking) return 0;
+    if (mode >= 0 && mode < RANKING_MODE_COUNT) return ranking->modes[mode].histogram.total;
+    uint32_t total = 0;
+    for (int m = 0; m < RANKING_MODE_COUNT; ++m) total += ranking->modes[m].histogram.total;
+    return total;
+}
+
+// Partidas do modo com pontuação maior que score
+static uint32_t runs_above(const RankingBoard *board, int score) {
+    const ScoreHistogram *h = &board->histogram;
+    if (score < 0) return h->total;         // pontuação negativa não existe no jogo
+    return h->total - histogram_prefix(h, score_bucket(score));
+}
+
+uint32_t ranking_place_of(const Ranking *ranking, RankingMode mode, int score) {
+    if (!ranking) return 1;
+    if (mode >= 0 && mode < RANKING_MODE_COUNT) return runs_above(&ranking->modes[mode], score) + 1;
+    uint32_t above = 0;
+    for (int m = 0; m < RANKING_MODE_COUNT; ++m) above += runs_above(&ranking->modes[m], score);
+    return above + 1;
+}
+
+double ranking_top_percent(const Ranking *ranking, RankingMode mode, int score) {
+    uint32_t total = ranking_total_runs(ranking, mode);
+    if (total == 0) return 100.0;
+    double percent = 100.0 * (double)ranking_place_of(ranking, mode, score) / (double)total;
+    return percent < 100.0 ? percent : 100.0;
 }
@@ -1,23 +1,191 @@
 #ifndef RANKING_H
 #define RANKING_H
 
+#include <stdint.h>
+
 #define MAX_NAME_LEN 31
 #define MAX_SCORES 200
+#define RANKING_SCORE_BUCKETS 4096      // pontuações >= 4095 dividem o último balde
+#define RANKING_RECENT 8                // últimas partidas guardadas por jogador
+#define RANKING_REPORT_BAD_LINES 8      // linhas ruins listadas no relatório (o resto só é contado)
+
+// Todas as partidas ficam no placar em disco (board.h: ranking.dat + ranking.idx ao lado do
+// ranking.txt, sem limite de tamanho), cada uma com o modo em que foi jogada.
+// Na memória, cada modo tem o seu top-K (MAX_SCORES) e o seu histograma: 1 jogador, 2 jogadores
+// e desafio do dia não disputam a mesma lista.
+// Os nomes ficam uma vez só em ranking.names (names.h); os registros guardam o id.
+
+typedef enum RankingMode {
+    RANKING_MODE_ALL = -1,          // consultas: todos os modos juntos
+    RANKING_MODE_SOLO = 0,          // 1 jogador (também tudo o que veio do ranking.txt antigo)
+    RANKING_MODE_DUO,               // 2 jogadores (a melhor pontuação da dupla)
+    RANKING_MODE_DAILY,             // desafio do dia (semente do dia)
+    RANKING_MODE_COUNT              // modo gravado >= COUNT (versão mais nova) é lido como SOLO
+} RankingMode;
 
 typedef struct ScoreEntry {
     char name[MAX_NAME_LEN + 1];
     int score;
+    uint32_t order;                 // chegada dentro do modo (desempate: quem chegou antes fica na frente)
 } ScoreEntry;
 
-typedef struct Ranking {
-    ScoreEntry items[MAX_SCORES];
+// Quantas partidas fizeram cada pontuação (todas, não só o top-K): árvore de Fenwick,
+// inserção e "quantas partidas ficaram acima" em O(log RANKING_SCORE_BUCKETS)
+typedef struct ScoreHistogram {
+    uint32_t tree[RANKING_SCORE_BUCKETS + 1];   // 1-based
+    uint32_t total;
+} ScoreHistogram;
+
+// Top-K de um modo: min-heap (heap[0] = a pior das K). Quem não passa da raiz é recusado em O(1);
+// a lista ordenada só é montada quando alguém vai mostrar (ranking_top).
+typedef struct RankingBoard {
+    ScoreEntry heap[MAX_SCORES];
     int count;
+    uint32_t arrivals;
+    ScoreHistogram histogram;
+} RankingBoard;
+
+typedef struct Ranking {
+    RankingBoard modes[RANKING_MODE_COUNT];
 } Ranking;
 
-// Carrega ranking do arquivo
+// Nome do modo para as telas ("1 jogador", ...; RANKING_MODE_ALL = "Todos")
+const char *ranking_mode_name(RankingMode mode);
+
+/**
+ * Top-K do modo em ordem (pontuação decrescente; empate: quem chegou antes), O(K log K)
+ * @param out Pelo menos MAX_SCORES entradas
+ * @return Quantas foram escritas
+ */
+int ranking_top(const Ranking *ranking, RankingMode mode, ScoreEntry *out);
+
+// Carrega o top-K e o histograma de cada modo (do placar; ranking.txt antigo só se o placar ainda não existir)
 void ranking_load(Ranking *ranking, const char *filepath);
 
-// Função principal: adiciona pontuação, ordena com insertion sort e salva automaticamente
-void ranking_add(Ranking *ranking, const char *name, int score, const char *filepath);
+// Como foi o último ranking_load
+typedef struct RankingLoadReport {
+    int from_service;               // 1 = veio do rankd (o resto dos campos não se aplica)
+    int from_board;                 // 1 = placar binário, 0 = ranking.txt (ou nada)
+    uint32_t lines;                 // linhas (ou registros) lidas
+    uint32_t loaded;                // partidas aceitas
+    uint32_t malformed;             // linhas que não são "nome;pontos"
+    uint32_t bad_lines[RANKING_REPORT_BAD_LINES];   // números (1-based) das primeiras linhas ruins
+    int torn_tail;                  // última linha sem '\n' (escrita cortada): ignorada
+    double ms;
+} RankingLoadReport;
+
+void ranking_load_report(RankingLoadReport *out);
+
+/**
+ * Lê um ranking.txt antigo ("nome;pontos" por linha) com o scanner mapeado, sem montar ranking
+ * fn recebe cada linha boa, na ordem do arquivo (nome já limpo, como o ranking_add gravaria).
+ * @param report Opcional: soma linhas, aceitas, ruins e linha cortada no fim
+ * @return 0 se o arquivo não abre
+ */
+typedef void (*RankingLineFn)(void *ctx, const char *name, int score);
+int ranking_scan_text(const char *filepath, RankingLineFn fn, void *ctx, RankingLoadReport *report);
+
+/**
+ * Registra a partida no top-K do modo e grava no placar
+ * Toda partida é gravada, mesmo a que não entra no top-K; essas não tocam no heap (O(1)).
+ * @param seed Semente do mapa (desafio do dia); 0 = desconhecida
+ * @param filepath Caminho do ranking (o placar fica ao lado); NULL = só em memória
+ */
+void ranking_add(Ranking *ranking, RankingMode mode, uint32_t seed, const char *name, int score, const char *filepath);
+
+/**
+ * Colocação de uma pontuação entre todas as partidas já jogadas no modo
+ * @return 1 + partidas com pontuação maior (empates dividem a melhor colocação); 1 se não há partidas
+ */
+uint32_t ranking_place_of(const Ranking *ranking, RankingMode mode, int score);
+
+// Total de partidas já jogadas no modo (inclui as que não entraram no top-K)
+uint32_t ranking_total_runs(const Ranking *ranking, RankingMode mode);
+
+// Colocação em porcentagem do total do modo ("top 2%"): 100 * colocação / total
+double ranking_top_percent(const Ranking *ranking, RankingMode mode, int score);
+
+// Resumo de um jogador (todas as partidas dele)
+typedef struct PlayerStats {
+    int best;
+    uint32_t runs;
+    double mean;
+    int recent[RANKING_RECENT];     // recent[0] = a mais recente
+    int recent_count;
+} PlayerStats;
+
+/**
+ * Recorde, partidas, média e histórico recente do jogador, O(1) (hash do nome + índice por id)
+ * Vale para o último ranking carregado (ranking_load) mais o que entrou por ranking_add nesse arquivo.
+ * @return 0 se o jogador nunca jogou
+ */
+int ranking_player_stats(const char *name, PlayerStats *out);
+
+/**
+ * Sobe a thread de escrita do ranking: a partir daqui ranking_add nesse arquivo não toca o disco
+ * (enfileira; a thread agrupa, grava no placar e faz fsync com frequência limitada)
+ * Chamar depois do ranking_load do mesmo arquivo. Se o placar ainda não existe, importa os top-K carregados.
+ * ranking_writer_stop (também registrado no atexit) grava o resto.
+ * @return 0 se não deu para criar a thread (ranking_add continua escrevendo direto)
+ */
+int ranking_writer_start(const Ranking *ranking, const char *filepath);
+
+// Grava tudo o que está na fila, faz fsync e encerra a thread
+void ranking_writer_stop(void);
+
+// Uma linha da tela de ranking
+typedef struct RankingRow {
+    uint32_t place;                 // 1 + partidas com pontuação maior (empates dividem a colocação)
+    int score;
+    char name[MAX_NAME_LEN + 1];
+} RankingRow;
+
+// Jogador achado pela busca por nome
+typedef struct RankingMatch {
+    char name[MAX_NAME_LEN + 1];
+    int best;
+    uint32_t runs;                  // 0 = sem resumo do jogador (best/row não valem)
+    uint32_t row;                   // primeira linha (0-based) com o recorde dele
+} RankingMatch;
+
+/**
+ * Abre o ranking para a tela de ranking: linhas e busca sob demanda, sem carregar as partidas
+ * RANKING_MODE_ALL: o placar inteiro em disco (só lê; a thread de escrita continua gravando),
+ * foto do momento da abertura. Sem placar em disco, ou com um modo, as linhas são as do top-K.
+ * @return Quantas linhas há
+ */
+uint32_t ranking_view_open(const Ranking *ranking, RankingMode mode, const char *filepath);
+void ranking_view_close(void);
+uint32_t ranking_view_count(void);
+
+/**
+ * Linhas first..first+max-1 (0-based, ordem do placar), O(log n) para chegar em first
+ * @return Quantas foram escritas em out
+ */
+int ranking_view_rows(uint32_t first, RankingRow *out, int max);
+
+// Primeira linha (0-based) com essa pontuação ou menor
+uint32_t ranking_view_row_of_score(int score);
+
+// Linha da partida do jogador com essa pontuação (a primeira dele entre os empates; senão a primeira do empate)
+uint32_t ranking_view_row_of_player(const char *name, int score);
+
+/**
+ * Jogadores cujo nome começa com prefix, em ordem alfabética (O(log n) + os devolvidos)
+ * @param total Opcional: quantos batem ao todo (out recebe só os max primeiros)
+ * @return Quantos foram escritos em out
+ */
+int ranking_view_find(const char *prefix, RankingMatch *out, int max, uint32_t *total);
+
+/**
+ * Conecta no rankd (placar compartilhado entre processos do host, ver rankproto.h)
+ * Conectado, ranking_load/ranking_add/ranking_player_stats passam pelo daemon; se ele cair,
+ * voltam sozinhos para o arquivo.
+ * @param socket_path NULL = $CROSSY_RANKD ou o caminho padrão
+ * @return 0 se não há daemon (o jogo segue com o arquivo)
+ */
+int ranking_service_connect(const char *socket_path);
+void ranking_service_disconnect(void);
+int ranking_service_active(void);
 
 #endif // RANKING_H
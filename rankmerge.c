@@ -0,0 +1,36 @@
+// Junta os rankings de várias máquinas num placar global (merge.h).
+//
+// Uso: rankmerge SAIDA ENTRADA...
+//   SAIDA     ranking de saída (ex.: global.txt -> global.dat/.idx/.names); não pode existir
+//   ENTRADA   placar de uma máquina (loja1/ranking.txt usa loja1/ranking.dat ao lado)
+//             ou ranking.txt antigo ("nome;pontos" por linha)
+// A mesma partida vinda de duas entradas entra uma vez. Depois, o jogo (ou o rankd) abre a
+// saída como qualquer outro ranking: ./bin/crossy com global.txt, rankd --file global.txt.
+
+#include "merge.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) {
+        fprintf(stderr, "uso: %s SAIDA ENTRADA...\n", argv[0]);
+        return 2;
+    }
+
+    trace_start(getenv("CROSSY_TRACE"));
+    MergeReport report;
+    int ok = merge_rankings((const char *const *)(argv + 2), argc - 2, argv[1], &report);
+    trace_stop();
+
+    if (!ok) {
+        fprintf(stderr, "rankmerge: falhou, nada foi gravado\n");
+        return 1;
+    }
+    printf("rankmerge: %d entradas (%d sequencias), %u partidas lidas em %.0f ms\n", report.inputs, report.runs,
+           report.read, report.ms);
+    printf("  %u gravadas em %s, %u repetidas descartadas, %u linhas ruins\n", report.written, argv[1],
+           report.duplicates, report.malformed);
+    return 0;
+}
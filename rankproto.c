@@ -0,0 +1,125 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L  // sockets/timeouts com -std=c99
+#endif
+
+#include "rankproto.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+const char *rankproto_socket_path(void)
+{
+    const char *path = getenv(RANKPROTO_SOCKET_ENV);
+    return path && path[0] ? path : RANKPROTO_DEFAULT_SOCKET;
+}
+
+#ifdef _WIN32
+
+int rankproto_connect(const char *path) { (void)path; return -1; }
+int rankproto_listen(const char *path) { (void)path; return -1; }
+void rankproto_close(int fd) { (void)fd; }
+int rankproto_send(int fd, const void *buf, int len) { (void)fd; (void)buf; (void)len; return 0; }
+int rankproto_recv(int fd, void *buf, int len) { (void)fd; (void)buf; (void)len; return 0; }
+
+#else
+
+// Sem SIGPIPE: escrever num daemon que morreu tem que virar erro, não derrubar o jogo
+#ifdef MSG_NOSIGNAL
+#define RANKPROTO_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define RANKPROTO_SEND_FLAGS 0
+#endif
+
+static int make_address(const char *path, struct sockaddr_un *addr)
+{
+    if (!path || strlen(path) >= sizeof(addr->sun_path)) return 0;
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    strcpy(addr->sun_path, path);
+    return 1;
+}
+
+int rankproto_connect(const char *path)
+{
+    struct sockaddr_un addr;
+    if (!make_address(path, &addr)) return -1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    struct timeval tv;
+    tv.tv_sec = RANKPROTO_TIMEOUT_MS / 1000;
+    tv.tv_usec = (RANKPROTO_TIMEOUT_MS % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    return fd;
+}
+
+int rankproto_listen(const char *path)
+{
+    struct sockaddr_un addr;
+    if (!make_address(path, &addr)) return -1;
+
+    // Alguém atende? Então já tem daemon. Senão o arquivo é de um daemon que morreu
+    int other = rankproto_connect(path);
+    if (other >= 0) {
+        close(other);
+        return -1;
+    }
+    unlink(path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void rankproto_close(int fd)
+{
+    if (fd >= 0) close(fd);
+}
+
+int rankproto_send(int fd, const void *buf, int len)
+{
+    const char *p = (const char *)buf;
+    while (len > 0) {
+        ssize_t n = send(fd, p, (size_t)len, RANKPROTO_SEND_FLAGS);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        p += n;
+        len -= (int)n;
+    }
+    return 1;
+}
+
+int rankproto_recv(int fd, void *buf, int len)
+{
+    char *p = (char *)buf;
+    while (len > 0) {
+        ssize_t n = recv(fd, p, (size_t)len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        p += n;
+        len -= (int)n;
+    }
+    return 1;
+}
+
+#endif
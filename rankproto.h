@@ -0,0 +1,72 @@
+#ifndef RANKPROTO_H
+#define RANKPROTO_H
+
+#include "ranking.h"
+#include <stdint.h>
+
+// Protocolo do rankd: um processo dono do placar, e os jogos do mesmo host (vários
+// gabinetes/processos) mandam inserções e consultas por um socket Unix em vez de cada
+// um escrever no próprio arquivo.
+//
+// Stream: o cliente manda um RankRequest e lê um RankReply seguido de reply.size bytes
+// (Ranking inteiro no SNAPSHOT, PlayerStats no PLAYER). Mesmo host e mesmo build: as structs
+// vão em binário nativo, e version recusa um cliente de outro build.
+// No Windows não há cliente: o jogo sempre usa o arquivo.
+
+#define RANKPROTO_VERSION 2
+#define RANKPROTO_DEFAULT_SOCKET "/tmp/crossy_rankd.sock"
+#define RANKPROTO_SOCKET_ENV "CROSSY_RANKD"    // sobrescreve o caminho do socket
+#define RANKPROTO_TIMEOUT_MS 1000              // cliente desiste (e cai para o arquivo) depois disso
+
+typedef enum RankOp {
+    RANK_OP_ADD = 1,            // mode + seed + score + name -> place/total no modo depois de inserir
+    RANK_OP_SNAPSHOT,           // -> Ranking (top-K + histograma de cada modo)
+    RANK_OP_PLACE,              // mode + score -> place/total (RANKING_MODE_ALL = todos os modos)
+    RANK_OP_PLAYER              // name -> PlayerStats (status RANK_STATUS_UNKNOWN se nunca jogou)
+} RankOp;
+
+typedef enum RankStatus {
+    RANK_STATUS_ERROR = 0,
+    RANK_STATUS_OK,
+    RANK_STATUS_UNKNOWN
+} RankStatus;
+
+typedef struct RankRequest {
+    uint32_t version;
+    uint32_t op;
+    int32_t score;
+    int32_t mode;               // RankingMode
+    uint32_t seed;              // semente do percurso (desafio do dia); 0 no resto
+    char name[MAX_NAME_LEN + 1];
+} RankRequest;
+
+typedef struct RankReply {
+    uint32_t status;
+    uint32_t place;
+    uint32_t total;
+    uint32_t size;              // bytes que vêm depois
+} RankReply;
+
+// Caminho do socket: $CROSSY_RANKD ou RANKPROTO_DEFAULT_SOCKET
+const char *rankproto_socket_path(void);
+
+/**
+ * Conecta no rankd (com timeout de leitura/escrita RANKPROTO_TIMEOUT_MS)
+ * @return fd, ou -1 se não há daemon (ou no Windows)
+ */
+int rankproto_connect(const char *path);
+
+/**
+ * Abre o socket do daemon. Um arquivo de socket velho (daemon morto) é removido;
+ * se outro daemon responde nele, falha.
+ * @return fd, ou -1
+ */
+int rankproto_listen(const char *path);
+
+void rankproto_close(int fd);
+
+// Enviam/recebem exatamente len bytes. Retornam 1 em sucesso (0 = erro, timeout ou conexão fechada)
+int rankproto_send(int fd, const void *buf, int len);
+int rankproto_recv(int fd, void *buf, int len);
+
+#endif // RANKPROTO_H
@@ -4,13 +4,20 @@
 #include "ranking.h"
 #include "utils.h"
 #include "sound.h"
+#include "sim.h"
+#include "profiler.h"
+#include "trace.h"
+#include "mem.h"
 #include <string.h>
 #include <stdio.h>  
 #include <math.h>   
 
 static void render_menu_screen(int menu_index, const char** options, int count);
 static void render_help_screen(void);
-static void render_ranking_screen(const Ranking *ranking);
+typedef struct RankingScreen RankingScreen;
+static void ranking_screen_open(RankingScreen *screen, const Ranking *ranking, RankingMode mode);
+static int ranking_screen_update(RankingScreen *screen, const char *player_name);
+static void render_ranking_screen(const RankingScreen *screen);
 
 #define SCREEN_WIDTH 800
 #define SCREEN_HEIGHT 600
@@ -18,6 +25,13 @@ static void render_ranking_screen(const Ranking *ranking);
 #define MARGIN 50
 #define RANKING_FILE "ranking.txt"
 
+// Modo prática: histórico guardado e quanto cada BACKSPACE volta
+#define PRACTICE_REWIND_SECONDS 60
+#define PRACTICE_REWIND_STEP 2.0
+
+// Fantasma do desafio: opacidade do boneco gravado
+#define GHOST_ALPHA 0.45f
+
 // Cores usadas como fallback para fundos quando texturas não carregam
 #define COLOR_GRASS (Color){76, 175, 80, 255}
 #define COLOR_ROAD  (Color){97, 97, 97, 255}
@@ -26,6 +40,14 @@ static void render_ranking_screen(const Ranking *ranking);
 #define COLOR_PLAYER1 (Color){255, 193, 7, 255} 
 #define COLOR_PLAYER2 (Color){0, 200, 255, 255}    
 
+// Caminho de renderização padrão:
+// 0 = desenha no alvo virtual 800x600 e faz o blit escalado para a tela
+// 1 = desenha direto no backbuffer com uma Camera2D escalada (sem blit)
+// Pode ser alternado em tempo de execução com F2.
+#ifndef DIRECT_RENDER_DEFAULT
+#define DIRECT_RENDER_DEFAULT 0
+#endif
+
 // Estados do jogo
 typedef enum {
     GAME_START_SCREEN,
@@ -37,6 +59,41 @@ typedef enum {
     GAME_RANKING_SCREEN
 } GameScreen;
 
+// Tela de ranking: janela sobre o placar inteiro (milhões de partidas)
+// Só as linhas visíveis são lidas e formatadas, e só quando a janela muda; o desenho reusa o texto pronto.
+#define RANKING_PAGE_ROWS 10
+#define RANKING_MATCHES_SHOWN 8
+#define RANKING_WHEEL_ROWS 3
+
+typedef struct RankingScreenRow {
+    RankingRow row;
+    char place[16];                 // "#1.234"
+    char score[16];
+    int score_width;
+} RankingScreenRow;
+
+struct RankingScreen {
+    const Ranking *ranking;         // para trocar de modo (TAB)
+    RankingMode mode;               // RANKING_MODE_ALL = placar inteiro; senão o top-K do modo
+    uint32_t total;
+    char total_text[48];
+    uint32_t first;                 // primeira linha visível
+    uint32_t cached_first;          // janela já formatada em rows (UINT32_MAX = nenhuma)
+    int row_count;
+    RankingScreenRow rows[RANKING_PAGE_ROWS];
+    uint32_t highlight;             // linha marcada pelo "ir para" (UINT32_MAX = nenhuma)
+    char status[64];                // "linhas a-b de n" ou aviso da última ação
+
+    int searching;
+    char query[MAX_NAME_LEN];
+    int query_len;
+    RankingMatch matches[RANKING_MATCHES_SHOWN];
+    char match_text[RANKING_MATCHES_SHOWN][64];
+    int match_count;
+    uint32_t match_total;
+    int match_index;
+};
+
 // Variáveis estáticas para armazenar as texturas dos sprites
 static Texture2D car_texture = {0}; // Sprite do carro
 static Texture2D log_texture = {0}; // Sprite do tronco
@@ -48,49 +105,92 @@ static Texture2D grass_texture = {0}; // Textura do gramado
 static Texture2D river_texture = {0}; // Textura do rio
 static Texture2D road_texture = {0};  // Textura da rua
 
+// Painel de alocações (F4)
+static int mem_panel_visible = 0;
+static MemReport mem_panel_report;
+
+// ----- Texturas contabilizadas em MEM_ASSETS -----
+
+// Estimativa do que a textura ocupa na GPU (RGBA8, sem mipmaps)
+static long long texture_bytes(Texture2D tex) {
+    return (long long)tex.width * tex.height * 4;
+}
+
+static Texture2D load_tracked_texture(const char *path) {
+    Texture2D tex = LoadTexture(path);
+    if (tex.id != 0) mem_note(MEM_ASSETS, texture_bytes(tex));
+    return tex;
+}
+
+static void unload_tracked_texture(Texture2D *tex) {
+    if (tex->id == 0) return;
+    mem_note(MEM_ASSETS, -texture_bytes(*tex));
+    UnloadTexture(*tex);
+    *tex = (Texture2D){0};
+}
+
 // ----- Funções de desenho de sprites -----
 
-// Desenha o jogador no modo 1 jogador (sprite do pássaro)
-static void draw_player_voxel_old(int x, int y) {
-    if (bird_texture.id != 0) {
+/*
+ * Desenha um sprite de uma célula numa posição horizontal fracionária da faixa do mapa
+ * Se a célula sai parcialmente por uma borda, o pedaço que sobra reaparece na borda oposta
+ * (mesmo comportamento da fila circular), recortando o retângulo de origem do sprite
+ * @param lane_x Posição X em pixels relativa ao início da faixa (pode ser negativa)
+ * @param y Posição Y em pixels na tela virtual
+ */
+static void draw_sprite_wrapped(Texture2D tex, float lane_x, float y) {
+    if (tex.id == 0) return;
+
+    const float lane_w = (float)(MAP_WIDTH * CELL_SIZE);
+    float x = fmodf(lane_x, lane_w);
+    if (x < 0.0f) x += lane_w;
+
+    float first_w = lane_w - x;                 // quanto da célula cabe antes da borda direita
+    if (first_w >= (float)CELL_SIZE) {
         DrawTexturePro(
-            bird_texture,
-            (Rectangle){0, 0, (float)bird_texture.width, (float)bird_texture.height},
-            (Rectangle){(float)x, (float)y, (float)CELL_SIZE, (float)CELL_SIZE},
+            tex,
+            (Rectangle){0, 0, (float)tex.width, (float)tex.height},
+            (Rectangle){MARGIN + x, y, (float)CELL_SIZE, (float)CELL_SIZE},
             (Vector2){0, 0},
             0.0f,
             WHITE
         );
+        return;
     }
+
+    float cut = first_w / (float)CELL_SIZE;     // fração do sprite que fica na borda direita
+    DrawTexturePro(
+        tex,
+        (Rectangle){0, 0, tex.width * cut, (float)tex.height},
+        (Rectangle){MARGIN + x, y, first_w, (float)CELL_SIZE},
+        (Vector2){0, 0},
+        0.0f,
+        WHITE
+    );
+    DrawTexturePro(
+        tex,
+        (Rectangle){tex.width * cut, 0, tex.width * (1.0f - cut), (float)tex.height},
+        (Rectangle){(float)MARGIN, y, (float)CELL_SIZE - first_w, (float)CELL_SIZE},
+        (Vector2){0, 0},
+        0.0f,
+        WHITE
+    );
 }
-static void draw_car_voxel(int x, int y) {
-    if (car_texture.id != 0) {
-        DrawTexturePro(
-            car_texture,
-            (Rectangle){0, 0, (float)car_texture.width, (float)car_texture.height},
-            (Rectangle){(float)x, (float)y, (float)CELL_SIZE, (float)CELL_SIZE},
-            (Vector2){0, 0},
-            0.0f,
-            WHITE
-        );
-    }
+
+// Desenha o jogador no modo 1 jogador (sprite do pássaro)
+static void draw_player_voxel_old(float lane_x, float y) {
+    draw_sprite_wrapped(bird_texture, lane_x, y);
 }
-static void draw_log_voxel(int x, int y) {
-    if (log_texture.id != 0) {
-        DrawTexturePro(
-            log_texture,
-            (Rectangle){0, 0, (float)log_texture.width, (float)log_texture.height},
-            (Rectangle){(float)x, (float)y, (float)CELL_SIZE, (float)CELL_SIZE},
-            (Vector2){0, 0},
-            0.0f,
-            WHITE
-        );
-    }
+static void draw_car_voxel(float lane_x, float y) {
+    draw_sprite_wrapped(car_texture, lane_x, y);
 }
-// Render de linhas e jogo
-static void render_row(const Row *row, int y, int player_x, int player_y) {
+static void draw_log_voxel(float lane_x, float y) {
+    draw_sprite_wrapped(log_texture, lane_x, y);
+}
+
+// Desenha o fundo (textura ou cor sólida) de uma linha na altura start_y
+static void render_row_background(const Row *row, float start_y) {
     int start_x = MARGIN;
-    int start_y = MARGIN + y * CELL_SIZE;
 
     Color bg_color;
     switch (row->type) {
@@ -99,41 +199,17 @@ static void render_row(const Row *row, int y, int player_x, int player_y) {
         case ROW_RIVER: bg_color = COLOR_RIVER; break;
     }
 
-    // Desenha o fundo da linha
-    if (row->type == ROW_GRASS && grass_texture.id != 0) {
-        // Usa a textura do gramado se disponível
-        // Desenha a textura repetida para cobrir toda a largura da linha
-        for (int x = 0; x < MAP_WIDTH * CELL_SIZE; x += CELL_SIZE) {
-            DrawTexturePro(
-                grass_texture,
-                (Rectangle){0, 0, (float)grass_texture.width, (float)grass_texture.height},
-                (Rectangle){(float)(start_x + x), (float)start_y, (float)CELL_SIZE, (float)CELL_SIZE},
-                (Vector2){0, 0},
-                0.0f,
-                WHITE
-            );
-        }
-    } else if (row->type == ROW_ROAD && road_texture.id != 0) {
-        // Usa a textura da estrada se disponível
-        // Desenha a textura repetida para cobrir toda a largura da linha
-        for (int x = 0; x < MAP_WIDTH * CELL_SIZE; x += CELL_SIZE) {
-            DrawTexturePro(
-                road_texture,
-                (Rectangle){0, 0, (float)road_texture.width, (float)road_texture.height},
-                (Rectangle){(float)(start_x + x), (float)start_y, (float)CELL_SIZE, (float)CELL_SIZE},
-                (Vector2){0, 0},
-                0.0f,
-                WHITE
-            );
-        }
-    } else if (row->type == ROW_RIVER && river_texture.id != 0) {
-        // Usa a textura do rio se disponível
+    Texture2D bg_texture = (row->type == ROW_GRASS) ? grass_texture :
+                           (row->type == ROW_ROAD)  ? road_texture  : river_texture;
+
+    if (bg_texture.id != 0) {
+        // Usa a textura da linha se disponível
         // Desenha a textura repetida para cobrir toda a largura da linha
         for (int x = 0; x < MAP_WIDTH * CELL_SIZE; x += CELL_SIZE) {
             DrawTexturePro(
-                river_texture,
-                (Rectangle){0, 0, (float)river_texture.width, (float)river_texture.height},
-                (Rectangle){(float)(start_x + x), (float)start_y, (float)CELL_SIZE, (float)CELL_SIZE},
+                bg_texture,
+                (Rectangle){0, 0, (float)bg_texture.width, (float)bg_texture.height},
+                (Rectangle){(float)(start_x + x), start_y, (float)CELL_SIZE, (float)CELL_SIZE},
                 (Vector2){0, 0},
                 0.0f,
                 WHITE
@@ -141,55 +217,86 @@ static void render_row(const Row *row, int y, int player_x, int player_y) {
         }
     } else {
         // Fallback: usa cor sólida se a textura não foi carregada
-        DrawRectangle(start_x, start_y, MAP_WIDTH * CELL_SIZE, CELL_SIZE, bg_color);
+        DrawRectangleRec((Rectangle){(float)start_x, start_y, (float)(MAP_WIDTH * CELL_SIZE), (float)CELL_SIZE}, bg_color);
         
         // Desenha linhas da estrada (faixas brancas) apenas se não usar textura
-        if (row->type == ROW_ROAD && road_texture.id == 0) {
+        if (row->type == ROW_ROAD) {
             for (int x = 0; x < MAP_WIDTH * CELL_SIZE; x += CELL_SIZE * 2) {
-                DrawRectangle(start_x + x, start_y + CELL_SIZE/2 - 1, CELL_SIZE, 2, WHITE);
+                DrawRectangleRec((Rectangle){(float)(start_x + x), start_y + CELL_SIZE/2 - 1, (float)CELL_SIZE, 2}, WHITE);
             }
         }
     }
+}
+
+/*
+ * Deslocamento interpolado (em células) de um jogador parado numa linha
+ * Em cima de um tronco o jogador acompanha a faixa, porque será empurrado junto na rotação
+ */
+static float player_lane_offset(const Row *row, int player_x, float lane_offset) {
+    if (row->type != ROW_RIVER || !row->queue) return 0.0f;
+    return (queue_get_cell(row->queue, player_x) == CHAR_LOG) ? lane_offset : 0.0f;
+}
+
+// Render de linhas e jogo
+// alpha: fração do tick já decorrida; scroll_px: deslocamento vertical interpolado do mundo
+static void render_row(const Row *row, int y, int player_x, int player_y, float alpha, float scroll_px) {
+    float start_y = MARGIN + y * CELL_SIZE + scroll_px;
+    float lane_offset = game_row_offset(row, alpha);
+
+    render_row_background(row, start_y);
 
     if (row->queue) {
         for (int x = 0; x < MAP_WIDTH; ++x) {
             char cell = queue_get_cell(row->queue, x);
-            int cell_x = start_x + x * CELL_SIZE;
+            float cell_x = (x + lane_offset) * CELL_SIZE;
 
             if (cell == CHAR_CAR)      draw_car_voxel(cell_x, start_y);
             else if (cell == CHAR_LOG) draw_log_voxel(cell_x, start_y);
             else if (cell == CHAR_LIFE) {
-                // Desenha poder de vida (coração)
+                // Desenha poder de vida (coração) - só existe em grama, que não se move
+                int heart_x = MARGIN + x * CELL_SIZE;
+                int heart_y = (int)start_y;
                 if (heart_texture.id != 0) {
                     // Usa o sprite do coração se disponível
                     DrawTexturePro(
                         heart_texture,
                         (Rectangle){0, 0, (float)heart_texture.width, (float)heart_texture.height},
-                        (Rectangle){(float)cell_x, (float)start_y, (float)CELL_SIZE, (float)CELL_SIZE},
+                        (Rectangle){(float)heart_x, start_y, (float)CELL_SIZE, (float)CELL_SIZE},
                         (Vector2){0, 0},
                         0.0f,
                         WHITE
                     );
                 } else {
                     // Fallback: desenha coração com formas geométricas
-                    DrawCircle(cell_x + CELL_SIZE/2, start_y + CELL_SIZE/2, CELL_SIZE/3, RED);
-                    DrawText("+", cell_x + CELL_SIZE/2 - 5, start_y + CELL_SIZE/2 - 8, 16, WHITE);
+                    DrawCircle(heart_x + CELL_SIZE/2, heart_y + CELL_SIZE/2, CELL_SIZE/3, RED);
+                    DrawText("+", heart_x + CELL_SIZE/2 - 5, heart_y + CELL_SIZE/2 - 8, 16, WHITE);
                 }
             }
         }
     }
 
     if (player_y == y) {
-        int player_x_pos = start_x + player_x * CELL_SIZE;
-        draw_player_voxel_old(player_x_pos, start_y);
+        float px = (player_x + player_lane_offset(row, player_x, lane_offset)) * CELL_SIZE;
+        draw_player_voxel_old(px, start_y);
     }
 }
 
-static void render_game(const GameState *state) {
+// Esconde o que passa das bordas durante o scroll interpolado: a última linha saindo por baixo
+// e a parte da linha que está entrando (desenhada em y = -1) que ainda está acima do tabuleiro
+static void mask_scroll_overflow(float scroll_px) {
+    if (scroll_px <= 0.0f) return;
+    DrawRectangleRec((Rectangle){(float)MARGIN, (float)(MARGIN + MAP_HEIGHT * CELL_SIZE),
+                                 (float)(MAP_WIDTH * CELL_SIZE), scroll_px + 1.0f}, BLACK);
+    DrawRectangleRec((Rectangle){(float)MARGIN, (float)(MARGIN - CELL_SIZE),
+                                 (float)(MAP_WIDTH * CELL_SIZE), (float)CELL_SIZE}, BLACK);
+}
+
+static void render_game(const GameState *state, float alpha) {
     ClearBackground(BLACK);
 
     // Se está renascendo, mostra tela de renascimento
     if (state->renascendo) {
+        PROF_BEGIN(PROF_HUD);
         // Fundo semi-transparente
         DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, (Color){0, 0, 0, 200});
         
@@ -203,12 +310,20 @@ static void render_game(const GameState *state) {
         snprintf(countdown_text, sizeof(countdown_text), "Reaparecendo em %d...", countdown);
         DrawText(countdown_text, SCREEN_WIDTH/2 - 120, SCREEN_HEIGHT/2 - 20, 24, YELLOW);
         
+        PROF_END(PROF_HUD);
         return; // Não renderiza o jogo durante renascimento
     }
 
+    PROF_BEGIN(PROF_PLAYFIELD);
+    float scroll_px = game_scroll_offset(state, alpha) * CELL_SIZE;
+    if (scroll_px > 0.0f) render_row(&state->incoming, -1, state->player_x, state->player_y, alpha, scroll_px);
     for (int y = 0; y < MAP_HEIGHT; ++y) {
-        render_row(&state->rows[y], y, state->player_x, state->player_y);
+        render_row(&state->rows[y], y, state->player_x, state->player_y, alpha, scroll_px);
     }
+    mask_scroll_overflow(scroll_px);
+    PROF_END(PROF_PLAYFIELD);
+
+    PROF_BEGIN(PROF_HUD);
 
     DrawRectangleLines(MARGIN, MARGIN, MAP_WIDTH * CELL_SIZE, MAP_HEIGHT * CELL_SIZE, WHITE);
 
@@ -257,6 +372,7 @@ static void render_game(const GameState *state) {
             if (cell == CHAR_LOG) DrawText("Em cima do tronco - seguro!", MARGIN, 75, 16, GREEN);
         }
     }
+    PROF_END(PROF_HUD);
 }
 
 // Modo 2 jogadores
@@ -269,76 +385,22 @@ static void render_game(const GameState *state) {
  * @param p2_x, p2_y Posição do Jogador 2
  * @param p1_alive Flag: 1 se P1 está vivo, 0 se morto
  * @param p2_alive Flag: 1 se P2 está vivo, 0 se morto
+ * @param alpha Fração do tick já decorrida (interpolação das faixas)
+ * @param scroll_px Deslocamento vertical interpolado do mundo em pixels
  */
-static void render_row_two(const Row *row, int y, int p1_x, int p1_y, int p2_x, int p2_y, int p1_alive, int p2_alive) {
-    int start_x = MARGIN;
-    int start_y = MARGIN + y * CELL_SIZE;
-
-    // Define cor de fundo baseada no tipo de linha
-    Color bg_color;
-    switch (row->type) {
-        case ROW_GRASS: bg_color = COLOR_GRASS; break;
-        case ROW_ROAD:  bg_color = COLOR_ROAD;  break;
-        case ROW_RIVER: bg_color = COLOR_RIVER; break;
-    }
+static void render_row_two(const Row *row, int y, int p1_x, int p1_y, int p2_x, int p2_y, int p1_alive, int p2_alive,
+                           float alpha, float scroll_px) {
+    float start_y = MARGIN + y * CELL_SIZE + scroll_px;
+    float lane_offset = game_row_offset(row, alpha);
 
     // Desenha o fundo da linha
-    if (row->type == ROW_GRASS && grass_texture.id != 0) {
-        // Usa a textura do gramado se disponível
-        // Desenha a textura repetida para cobrir toda a largura da linha
-        for (int x = 0; x < MAP_WIDTH * CELL_SIZE; x += CELL_SIZE) {
-            DrawTexturePro(
-                grass_texture,
-                (Rectangle){0, 0, (float)grass_texture.width, (float)grass_texture.height},
-                (Rectangle){(float)(start_x + x), (float)start_y, (float)CELL_SIZE, (float)CELL_SIZE},
-                (Vector2){0, 0},
-                0.0f,
-                WHITE
-            );
-        }
-    } else if (row->type == ROW_ROAD && road_texture.id != 0) {
-        // Usa a textura da estrada se disponível
-        // Desenha a textura repetida para cobrir toda a largura da linha
-        for (int x = 0; x < MAP_WIDTH * CELL_SIZE; x += CELL_SIZE) {
-            DrawTexturePro(
-                road_texture,
-                (Rectangle){0, 0, (float)road_texture.width, (float)road_texture.height},
-                (Rectangle){(float)(start_x + x), (float)start_y, (float)CELL_SIZE, (float)CELL_SIZE},
-                (Vector2){0, 0},
-                0.0f,
-                WHITE
-            );
-        }
-    } else if (row->type == ROW_RIVER && river_texture.id != 0) {
-        // Usa a textura do rio se disponível
-        // Desenha a textura repetida para cobrir toda a largura da linha
-        for (int x = 0; x < MAP_WIDTH * CELL_SIZE; x += CELL_SIZE) {
-            DrawTexturePro(
-                river_texture,
-                (Rectangle){0, 0, (float)river_texture.width, (float)river_texture.height},
-                (Rectangle){(float)(start_x + x), (float)start_y, (float)CELL_SIZE, (float)CELL_SIZE},
-                (Vector2){0, 0},
-                0.0f,
-                WHITE
-            );
-        }
-    } else {
-        // Fallback: usa cor sólida se a textura não foi carregada
-        DrawRectangle(start_x, start_y, MAP_WIDTH * CELL_SIZE, CELL_SIZE, bg_color);
-        
-        // Desenha linhas da estrada (faixas brancas) apenas se não usar textura
-        if (row->type == ROW_ROAD && road_texture.id == 0) {
-            for (int x = 0; x < MAP_WIDTH * CELL_SIZE; x += CELL_SIZE * 2) {
-                DrawRectangle(start_x + x, start_y + CELL_SIZE/2 - 1, CELL_SIZE, 2, WHITE);
-            }
-        }
-    }
+    render_row_background(row, start_y);
 
     // Desenha obstáculos (carros e troncos)
     if (row->queue) {
         for (int x = 0; x < MAP_WIDTH; ++x) {
             char cell = queue_get_cell(row->queue, x);
-            int cell_x = start_x + x * CELL_SIZE;
+            float cell_x = (x + lane_offset) * CELL_SIZE;
 
             if (cell == CHAR_CAR)      draw_car_voxel(cell_x, start_y);
             else if (cell == CHAR_LOG) draw_log_voxel(cell_x, start_y);
@@ -348,32 +410,14 @@ static void render_row_two(const Row *row, int y, int p1_x, int p1_y, int p2_x,
 
     // Desenha P1 se estiver nesta linha e vivo (sprite do pássaro)
     if (p1_y == y && p1_alive) {
-        int p1_x_pos = start_x + p1_x * CELL_SIZE;
-        if (bird_texture.id != 0) {
-            DrawTexturePro(
-                bird_texture,
-                (Rectangle){0, 0, (float)bird_texture.width, (float)bird_texture.height},
-                (Rectangle){(float)p1_x_pos, (float)start_y, (float)CELL_SIZE, (float)CELL_SIZE},
-                (Vector2){0, 0},
-                0.0f,
-                WHITE
-            );
-        }
+        float p1_x_pos = (p1_x + player_lane_offset(row, p1_x, lane_offset)) * CELL_SIZE;
+        draw_sprite_wrapped(bird_texture, p1_x_pos, start_y);
     }
     
     // Desenha P2 se estiver nesta linha e vivo (sprite do coelho)
     if (p2_y == y && p2_alive) {
-        int p2_x_pos = start_x + p2_x * CELL_SIZE;
-        if (rabbit_texture.id != 0) {
-            DrawTexturePro(
-                rabbit_texture,
-                (Rectangle){0, 0, (float)rabbit_texture.width, (float)rabbit_texture.height},
-                (Rectangle){(float)p2_x_pos, (float)start_y, (float)CELL_SIZE, (float)CELL_SIZE},
-                (Vector2){0, 0},
-                0.0f,
-                WHITE
-            );
-        }
+        float p2_x_pos = (p2_x + player_lane_offset(row, p2_x, lane_offset)) * CELL_SIZE;
+        draw_sprite_wrapped(rabbit_texture, p2_x_pos, start_y);
     }
 }
 
@@ -381,7 +425,7 @@ static void render_row_two(const Row *row, int y, int p1_x, int p1_y, int p2_x,
  * Renderiza o jogo completo no modo 2 jogadores
  * Mostra ambos os jogadores, suas pontuações individuais e status (vivo/morto)
  */
-static void render_game_two(const GameState *state) {
+static void render_game_two(const GameState *state, float alpha) {
     ClearBackground(BLACK);
 
     // Obtém posições e estados de ambos os jogadores
@@ -394,9 +438,18 @@ static void render_game_two(const GameState *state) {
     int p2_score = game_get_player_score(state, 2);
 
     // Renderiza todas as linhas do mapa (incluindo ambos os jogadores)
+    PROF_BEGIN(PROF_PLAYFIELD);
+    float scroll_px = game_scroll_offset(state, alpha) * CELL_SIZE;
+    if (scroll_px > 0.0f) {
+        render_row_two(&state->incoming, -1, p1_x, p1_y, p2_x, p2_y, p1_alive, p2_alive, alpha, scroll_px);
+    }
     for (int y = 0; y < MAP_HEIGHT; ++y) {
-        render_row_two(&state->rows[y], y, p1_x, p1_y, p2_x, p2_y, p1_alive, p2_alive);
+        render_row_two(&state->rows[y], y, p1_x, p1_y, p2_x, p2_y, p1_alive, p2_alive, alpha, scroll_px);
     }
+    mask_scroll_overflow(scroll_px);
+    PROF_END(PROF_PLAYFIELD);
+
+    PROF_BEGIN(PROF_HUD);
 
     // Desenha bordas do mapa
     DrawRectangleLines(MARGIN, MARGIN, MAP_WIDTH * CELL_SIZE, MAP_HEIGHT * CELL_SIZE, WHITE);
@@ -419,6 +472,7 @@ static void render_game_two(const GameState *state) {
     } else {
         DrawText("P2: Morto", MARGIN, 75, 16, RED);
     }
+    PROF_END(PROF_HUD);
 }
 
 // ----- Telas -----
@@ -453,7 +507,7 @@ static void render_menu_screen(int menu_index, const char** options, int count)
         if (i == menu_index) DrawText(">", SCREEN_WIDTH/2 - 140, base_y + i*40, 26, c);
         
         // Para a opção de música, mostra o estado atual (ON/OFF)
-        if (i == 4) { // Índice da opção "Musica: ON/OFF"
+        if (i == 6) { // Índice da opção "Musica: ON/OFF"
             const char* music_status = sound_is_enabled() ? "Musica: ON" : "Musica: OFF";
             DrawText(music_status, SCREEN_WIDTH/2 - 110, base_y + i*40, 26, c);
         } else {
@@ -462,6 +516,18 @@ static void render_menu_screen(int menu_index, const char** options, int count)
     }
 }
 
+// Número com separador de milhar ("98.000")
+static void format_count(char *out, int size, uint32_t value) {
+    char digits[16];
+    int n = snprintf(digits, sizeof(digits), "%u", (unsigned)value);
+    int pos = 0;
+    for (int i = 0; i < n && pos < size - 1; ++i) {
+        if (i > 0 && (n - i) % 3 == 0 && pos < size - 2) out[pos++] = '.';
+        out[pos++] = digits[i];
+    }
+    out[pos] = '\0';
+}
+
 /**
  * Renderiza a tela de Game Over
  * Modo 2 jogadores: adaptada para mostrar resultados de ambos os jogadores
@@ -469,8 +535,12 @@ static void render_menu_screen(int menu_index, const char** options, int count)
  * @param player_name Nome do Jogador 1 (ou único jogador no modo 1P)
  * @param player2_name Nome do Jogador 2 (NULL no modo 1P)
  * @param two_players Flag: 1 = modo 2 jogadores, 0 = modo 1 jogador
+ * @param latency Latência entrada -> simulação da partida (p50/p99)
+ * @param ranking Ranking (já com a partida) para a colocação entre as partidas do modo; NULL = não mostra
+ * @param mode Placar em que a partida foi salva
  */
-static void render_game_over_screen(const GameState *state, const char *player_name, const char *player2_name, int two_players) {
+static void render_game_over_screen(const GameState *state, const char *player_name, const char *player2_name, int two_players,
+                                    const SimLatencyStats *latency, const Ranking *ranking, RankingMode mode) {
     ClearBackground(BLACK);
     DrawText("GAME OVER!", SCREEN_WIDTH/2 - 180, SCREEN_HEIGHT/2 - 170, 60, RED);
     
@@ -500,6 +570,32 @@ static void render_game_over_screen(const GameState *state, const char *player_n
     } else { // 1 jogador
         DrawText(TextFormat("Pontuação final: %d", state->score), SCREEN_WIDTH/2 - 100, SCREEN_HEIGHT/2 - 50, 24, WHITE);
         DrawText(TextFormat("Jogador: %s", player_name), SCREEN_WIDTH/2 - 80, SCREEN_HEIGHT/2 + 10, 20, YELLOW);
+
+        // Resumo do jogador (hash do nome: O(1), sem varrer o ranking)
+        PlayerStats stats;
+        if (ranking && ranking_player_stats(player_name, &stats)) {
+            const char *stats_text = TextFormat("Recorde %d | %u partidas | media %.0f", stats.best,
+                                                (unsigned)stats.runs, stats.mean);
+            int stats_width = MeasureText(stats_text, 18);
+            DrawText(stats_text, SCREEN_WIDTH/2 - stats_width/2, SCREEN_HEIGHT/2 + 150, 18, LIGHTGRAY);
+        }
+    }
+
+    // Colocação da pontuação salva (a melhor no 2P) entre as partidas do mesmo modo
+    if (ranking && ranking_total_runs(ranking, mode) > 0) {
+        int saved = state->score;
+        if (two_players) {
+            int p1_score = game_get_player_score(state, 1);
+            int p2_score = game_get_player_score(state, 2);
+            saved = p1_score > p2_score ? p1_score : p2_score;
+        }
+        char place[16], total[16];
+        format_count(place, sizeof(place), ranking_place_of(ranking, mode, saved));
+        format_count(total, sizeof(total), ranking_total_runs(ranking, mode));
+        const char *place_text = TextFormat("%s: #%s de %s partidas (top %.1f%%)", ranking_mode_name(mode), place, total,
+                                            ranking_top_percent(ranking, mode, saved));
+        int place_width = MeasureText(place_text, 20);
+        DrawText(place_text, SCREEN_WIDTH/2 - place_width/2, SCREEN_HEIGHT/2 + 120, 20, SKYBLUE);
     }
     
     // Instruções para o jogador - centralizadas
@@ -509,6 +605,13 @@ static void render_game_over_screen(const GameState *state, const char *player_n
     const char *menu_text = "'M' para voltar ao menu";
     int menu_width = MeasureText(menu_text, 20);
     DrawText(menu_text, SCREEN_WIDTH/2 - menu_width/2, SCREEN_HEIGHT/2 + 80, 20, GRAY);
+
+    // Latência de entrada da partida (canto inferior)
+    if (latency && latency->count > 0) {
+        DrawText(TextFormat("Latencia entrada: p50 %.1f ms | p99 %.1f ms (%d entradas)",
+                            latency->p50_ms, latency->p99_ms, latency->count),
+                 10, SCREEN_HEIGHT - 24, 16, DARKGRAY);
+    }
 }
 
 /**
@@ -550,14 +653,124 @@ static void render_name_input_screen(const char *buffer, int letterCount, const
     }
 }
 
-// ----- Loop principal com RenderTexture (resolução virtual) -----
+/*
+ * Converte uma tecla da fila do raylib em movimento de jogador
+ * Modo 1 jogador: WASD e setas movem o mesmo jogador (player_id 0)
+ * Modo 2 jogadores: WASD = P1, setas = P2
+ * @return 1 se a tecla é um movimento, 0 caso contrário
+ */
+static int map_move_key(int key, int two_players, int *player_id, char *move) {
+    int arrow = 1;
+    switch (key) {
+        case KEY_W: *move = 'W'; arrow = 0; break;
+        case KEY_S: *move = 'S'; arrow = 0; break;
+        case KEY_A: *move = 'A'; arrow = 0; break;
+        case KEY_D: *move = 'D'; arrow = 0; break;
+        case KEY_UP:    *move = 'W'; break;
+        case KEY_DOWN:  *move = 'S'; break;
+        case KEY_LEFT:  *move = 'A'; break;
+        case KEY_RIGHT: *move = 'D'; break;
+        default: return 0;
+    }
+    *player_id = two_players ? (arrow ? 2 : 1) : 0;
+    return 1;
+}
+
+/*
+ * Calcula a área (letterbox) onde a resolução virtual SCREEN_WIDTH x SCREEN_HEIGHT
+ * é desenhada na tela atual, mantendo a proporção
+ */
+static void compute_viewport(float *scale, float *dx, float *dy) {
+    float sw = (float)GetScreenWidth();
+    float sh = (float)GetScreenHeight();
+    float s = (sw / SCREEN_WIDTH < sh / SCREEN_HEIGHT) ? (sw / SCREEN_WIDTH) : (sh / SCREEN_HEIGHT);
+    *scale = s;
+    *dx = (sw - SCREEN_WIDTH * s) * 0.5f;
+    *dy = (sh - SCREEN_HEIGHT * s) * 0.5f;
+}
+
+/*
+ * Painel de alocações por subsistema (F4): bytes vivos, pico e alocações por segundo
+ * Os contadores são relidos 2x por segundo para a taxa não ficar pulando
+ */
+static void render_mem_panel(int x, int y) {
+    if (mem_panel_report.time == 0.0 || utils_now_seconds() - mem_panel_report.time >= 0.5) {
+        mem_report(&mem_panel_report);
+    }
+
+    const int line_h = 18;
+    DrawRectangle(x, y, 330, line_h * (MEM_TAG_COUNT + 1) + 10, Fade(BLACK, 0.75f));
+    DrawText("memoria     vivos(KB)  pico(KB)  aloc/s", x + 6, y + 5, 14, YELLOW);
+    for (int i = 0; i < MEM_TAG_COUNT; ++i) {
+        const MemTagStats *t = &mem_panel_report.tags[i];
+        // Alocações com o jogo rodando = caminho quente alocando (deveria ser 0)
+        Color c = (mem_panel_report.allocs_per_sec[i] > 0.0) ? ORANGE : RAYWHITE;
+        DrawText(TextFormat("%-10s %9.1f %9.1f %8.0f", mem_tag_name((MemTag)i),
+                            t->live_bytes / 1024.0, t->peak_bytes / 1024.0, mem_panel_report.allocs_per_sec[i]),
+                 x + 6, y + 5 + line_h * (i + 1), 14, c);
+    }
+}
+
+/*
+ * Fantasma do desafio: boneco translúcido na linha do mundo em que a partida gravada está
+ * A linha vem como id do mundo (world_head - y), então ela continua certa mesmo se as duas
+ * partidas tiverem rolado o mapa um número diferente de vezes (renascimentos)
+ */
+static void render_ghost(const GameState *state, const SimGhostView *ghost, const GhostRun *run, float alpha) {
+    if (!ghost || !ghost->active || state->renascendo) return;
+
+    DrawText(TextFormat("Fantasma (%s): %d%s", run->name, ghost->score, ghost->alive ? "" : " - fim"),
+             SCREEN_WIDTH - MARGIN - 260, 10, 20, Fade(WHITE, 0.8f));
+
+    int y = state->world_head - ghost->row_id;
+    if (!ghost->alive || y < 0 || y >= MAP_HEIGHT) return;
+
+    float start_y = MARGIN + y * CELL_SIZE + game_scroll_offset(state, alpha) * CELL_SIZE;
+    Rectangle dst = { (float)(MARGIN + ghost->x * CELL_SIZE), start_y, (float)CELL_SIZE, (float)CELL_SIZE };
+    if (bird_texture.id != 0) {
+        DrawTexturePro(bird_texture, (Rectangle){0, 0, (float)bird_texture.width, (float)bird_texture.height},
+                       dst, (Vector2){0, 0}, 0.0f, Fade(WHITE, GHOST_ALPHA));
+    } else {
+        DrawRectangleRec(dst, Fade(WHITE, GHOST_ALPHA));
+    }
+}
+
+/*
+ * Rodapé do modo prática: quanto dá para voltar e quanto o histórico custa
+ * Com a partida acabada, mostra como continuar (voltar no tempo ou sair)
+ */
+static void render_practice_hud(const RewindStats *rs, int game_over) {
+    if (!rs) return;
+    DrawRectangle(0, SCREEN_HEIGHT - 26, SCREEN_WIDTH, 26, Fade(BLACK, 0.6f));
+    DrawText(TextFormat("PRATICA  BACKSPACE volta %.0fs | historico %.1fs, %.1f KB/min | checkpoint %.1f us | volta %.2f ms",
+                        PRACTICE_REWIND_STEP, rs->history_seconds, rs->bytes_per_minute / 1024.0,
+                        rs->checkpoint_us, rs->last_restore_ms),
+             8, SCREEN_HEIGHT - 20, 14, RAYWHITE);
+
+    if (game_over) {
+        const char *title = "FIM DE JOGO";
+        const char *hint = "BACKSPACE volta no tempo  |  M volta ao menu";
+        DrawRectangle(0, SCREEN_HEIGHT/2 - 50, SCREEN_WIDTH, 100, Fade(BLACK, 0.7f));
+        DrawText(title, SCREEN_WIDTH/2 - MeasureText(title, 36)/2, SCREEN_HEIGHT/2 - 40, 36, RED);
+        DrawText(hint, SCREEN_WIDTH/2 - MeasureText(hint, 20)/2, SCREEN_HEIGHT/2 + 10, 20, WHITE);
+    }
+}
+
+// ----- Loop principal com RenderTexture (resolução virtual) ou desenho direto -----
 void raylib_run_game(Ranking *ranking) {
     SetConfigFlags(FLAG_VSYNC_HINT | FLAG_FULLSCREEN_MODE);
     InitWindow(0, 0, "Nova (Velha) Infancia - Crossy Road");
-    SetTargetFPS(60);
+    // ESC é tecla do jogo (voltar ao menu, cancelar, fechar a busca); sair é fechar a janela (Alt+F4)
+    SetExitKey(KEY_NULL);
+    // Desenha na taxa do monitor; a simulação continua em GAME_TICK_HZ fixos
+    int refresh_hz = GetMonitorRefreshRate(GetCurrentMonitor());
+    SetTargetFPS(refresh_hz > 0 ? refresh_hz : 60);
+    TRACE_BEGIN("sound_init");
     sound_init();
+    TRACE_END("sound_init");
 
     // Carrega as imagens da pasta sprites/
+    TRACE_BEGIN("load_assets");
     const char* sprite_paths[] = {
         "sprites/car.png",
         "sprites/log (1).png",
@@ -568,7 +781,7 @@ void raylib_run_game(Ranking *ranking) {
     
     // Carrega sprite do carro
     if (FileExists(sprite_paths[0])) {
-        car_texture = LoadTexture(sprite_paths[0]);
+        car_texture = load_tracked_texture(sprite_paths[0]);
         if (car_texture.id != 0) {
             TraceLog(LOG_INFO, "Sprite do carro carregado: %s", sprite_paths[0]);
         } else {
@@ -580,7 +793,7 @@ void raylib_run_game(Ranking *ranking) {
     
     // Carrega sprite do tronco
     if (FileExists(sprite_paths[1])) {
-        log_texture = LoadTexture(sprite_paths[1]);
+        log_texture = load_tracked_texture(sprite_paths[1]);
         if (log_texture.id != 0) {
             TraceLog(LOG_INFO, "Sprite do tronco carregado: %s", sprite_paths[1]);
         } else {
@@ -592,7 +805,7 @@ void raylib_run_game(Ranking *ranking) {
     
     // Carrega sprite do pássaro (jogador no modo 1 jogador)
     if (FileExists(sprite_paths[2])) {
-        bird_texture = LoadTexture(sprite_paths[2]);
+        bird_texture = load_tracked_texture(sprite_paths[2]);
         if (bird_texture.id != 0) {
             TraceLog(LOG_INFO, "Sprite do pássaro carregado: %s", sprite_paths[2]);
         } else {
@@ -604,7 +817,7 @@ void raylib_run_game(Ranking *ranking) {
     
     // Carrega sprite do coração (poder de vida)
     if (FileExists(sprite_paths[3])) {
-        heart_texture = LoadTexture(sprite_paths[3]);
+        heart_texture = load_tracked_texture(sprite_paths[3]);
         if (heart_texture.id != 0) {
             TraceLog(LOG_INFO, "Sprite do coração carregado: %s", sprite_paths[3]);
         } else {
@@ -616,7 +829,7 @@ void raylib_run_game(Ranking *ranking) {
     
     // Carrega sprite do coelho (jogador 2 no modo 2 jogadores)
     if (FileExists(sprite_paths[4])) {
-        rabbit_texture = LoadTexture(sprite_paths[4]);
+        rabbit_texture = load_tracked_texture(sprite_paths[4]);
         if (rabbit_texture.id != 0) {
             TraceLog(LOG_INFO, "Sprite do coelho carregado: %s", sprite_paths[4]);
         } else {
@@ -628,7 +841,7 @@ void raylib_run_game(Ranking *ranking) {
     
     // Carrega imagem de fundo do menu
     if (FileExists("sprites/MenuCrossy.png")) {
-        menu_texture = LoadTexture("sprites/MenuCrossy.png");
+        menu_texture = load_tracked_texture("sprites/MenuCrossy.png");
         if (menu_texture.id != 0) {
             TraceLog(LOG_INFO, "Imagem do menu carregada: sprites/MenuCrossy.png");
         } else {
@@ -640,7 +853,7 @@ void raylib_run_game(Ranking *ranking) {
     
     // Carrega textura do gramado
     if (FileExists("sprites/grama.png")) {
-        grass_texture = LoadTexture("sprites/grama.png");
+        grass_texture = load_tracked_texture("sprites/grama.png");
         if (grass_texture.id != 0) {
             TraceLog(LOG_INFO, "Textura do gramado carregada: sprites/grama.png");
         } else {
@@ -652,7 +865,7 @@ void raylib_run_game(Ranking *ranking) {
     
     // Carrega textura do rio
     if (FileExists("sprites/rio.png")) {
-        river_texture = LoadTexture("sprites/rio.png");
+        river_texture = load_tracked_texture("sprites/rio.png");
         if (river_texture.id != 0) {
             TraceLog(LOG_INFO, "Textura do rio carregada: sprites/rio.png");
         } else {
@@ -664,7 +877,7 @@ void raylib_run_game(Ranking *ranking) {
     
     // Carrega textura da estrada/rua
     if (FileExists("sprites/rua.png")) {
-        road_texture = LoadTexture("sprites/rua.png");
+        road_texture = load_tracked_texture("sprites/rua.png");
         if (road_texture.id != 0) {
             TraceLog(LOG_INFO, "Textura da estrada carregada: sprites/rua.png");
         } else {
@@ -674,16 +887,32 @@ void raylib_run_game(Ranking *ranking) {
         TraceLog(LOG_WARNING, "Arquivo não encontrado: sprites/rua.png");
     }
 
-    // Alvo de renderização virtual 800x600
+    TRACE_END("load_assets");
+
+    // Alvo de renderização virtual 800x600 (só existe no caminho com blit)
     const int VIRTUAL_W = SCREEN_WIDTH, VIRTUAL_H = SCREEN_HEIGHT;
-    RenderTexture2D target = LoadRenderTexture(VIRTUAL_W, VIRTUAL_H);
-    SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+    RenderTexture2D target = {0};
+    int direct_render = DIRECT_RENDER_DEFAULT;
 
-    GameState state;
+    // Estatísticas de tempo de frame do caminho atual (para comparar os dois modos)
+    double mode_frame_time = 0.0;
+    int mode_frames = 0;
+    double mode_label_until = 0.0;
+
+    // Simulação (thread própria) e o snapshot que o render está mostrando
+    static Sim sim;
+    const GameState *state = NULL;
     GameScreen current_screen = GAME_START_SCREEN;
     char player_name[MAX_NAME_LEN] = {0};
     char player2_name[MAX_NAME_LEN] = {0};  
     int two_players_mode = 0; 
+    int practice_mode = 0;      // prática: sem nome/ranking, com volta no tempo
+    int challenge_mode = 0;     // desafio do dia: semente do dia contra o fantasma do melhor
+    unsigned int challenge_seed = 0;
+    static RankingScreen ranking_screen;
+    static GhostRun challenge_ghost;    // melhor partida da semente (lida do disco; grande demais para a pilha)
+    int have_ghost = 0;
+    char ghost_file[GHOST_PATH_LEN];
 
     int name_input_letterCount = 0;
     char name_input_buffer[MAX_NAME_LEN] = {0};
@@ -691,13 +920,30 @@ void raylib_run_game(Ranking *ranking) {
     ranking_load(ranking, RANKING_FILE);
 
     int menu_index = 0;
-    const char* MENU_OPTS[] = { "Aprender a jogar", "Jogar (1 Jogador)", "Jogar (2 Jogadores)", "Ver ranking", "Musica: ON/OFF", "Voltar pro terminal" };
-    const int MENU_COUNT = 6;
+    const char* MENU_OPTS[] = { "Aprender a jogar", "Jogar (1 Jogador)", "Jogar (2 Jogadores)", "Desafio do dia (fantasma)",
+                                "Praticar (com rewind)", "Ver ranking", "Musica: ON/OFF", "Voltar pro terminal" };
+    const int MENU_COUNT = 8;
 
     int exit_requested = 0;
 
+    // Fração do próximo tick já decorrida, usada para interpolar o desenho
+    float sim_alpha = 0.0f;
+    // Latência entrada -> simulação da última partida (mostrada no game over)
+    SimLatencyStats latency = {0};
+
+    // Turbo (F5): ticks por período de simulação e medidor de ticks/s alcançados
+    static const int TURBO_SPEEDS[] = { 1, 10, 100, 1000, SIM_SPEED_UNBOUNDED };
+    const int TURBO_STEPS = (int)(sizeof(TURBO_SPEEDS) / sizeof(TURBO_SPEEDS[0]));
+    int turbo_index = 0;
+    SimRate turbo_rate = {0};
+
     while (!WindowShouldClose()) {
+        PROF_BEGIN(PROF_SOUND);
         sound_update();
+        PROF_END(PROF_SOUND);
+
+        PROF_BEGIN(PROF_INPUT);
+        TRACE_BEGIN("input");
         // Alternar fullscreen
         if (IsKeyPressed(KEY_F11) ||
             (IsKeyDown(KEY_LEFT_ALT) && IsKeyPressed(KEY_ENTER))) {
@@ -706,6 +952,32 @@ void raylib_run_game(Ranking *ranking) {
             SetWindowSize(GetMonitorWidth(mon), GetMonitorHeight(mon));
         }
 
+        // Alterna entre alvo virtual + blit e desenho direto no backbuffer
+        if (IsKeyPressed(KEY_F2)) {
+            if (mode_frames > 0) {
+                double avg_ms = mode_frame_time * 1000.0 / mode_frames;
+                TraceLog(LOG_INFO, "Render %s: %.3f ms/frame em media (%d frames)",
+                         direct_render ? "direto" : "virtual", avg_ms, mode_frames);
+            }
+            direct_render = !direct_render;
+            mode_frame_time = 0.0;
+            mode_frames = 0;
+            mode_label_until = GetTime() + 3.0;
+        }
+        mode_frame_time += GetFrameTime();
+        mode_frames++;
+
+        // Overlay do profiler de fases (só em builds com ENABLE_PROFILER)
+        if (IsKeyPressed(KEY_F3)) PROF_TOGGLE();
+        // Painel de alocações por subsistema
+        if (IsKeyPressed(KEY_F4)) mem_panel_visible = !mem_panel_visible;
+        // Turbo: 1x -> 10x -> 100x -> 1000x -> sem limite -> 1x
+        if (IsKeyPressed(KEY_F5)) {
+            turbo_index = (turbo_index + 1) % TURBO_STEPS;
+            sim_set_speed(&sim, TURBO_SPEEDS[turbo_index]);
+            turbo_rate = (SimRate){0};
+        }
+
         // ----- UPDATE -----
         switch (current_screen) {
             case GAME_START_SCREEN: {
@@ -715,16 +987,36 @@ void raylib_run_game(Ranking *ranking) {
                     if (menu_index == 0)      current_screen = GAME_HELP_SCREEN;
                     else if (menu_index == 1) { // Jogar (1 Jogador)
                         two_players_mode = 0;
+                        practice_mode = 0;
+                        challenge_mode = 0;
                         name_input_letterCount = 0; name_input_buffer[0] = '\0';
                         current_screen = GAME_NAME_INPUT_SCREEN;
                     } else if (menu_index == 2) { //  Jogar (2 Jogadores)
                         two_players_mode = 1;
+                        practice_mode = 0;
+                        challenge_mode = 0;
                         name_input_letterCount = 0; name_input_buffer[0] = '\0';
                         player2_name[0] = '\0';
                         current_screen = GAME_NAME_INPUT_SCREEN;
-                    } else if (menu_index == 3) current_screen = GAME_RANKING_SCREEN;
-                    else if (menu_index == 4) sound_toggle(); // Alterna música
-                    else if (menu_index == 5) exit_requested = 1;
+                    } else if (menu_index == 3) { // Desafio do dia: 1 jogador, com nome (entra no ranking)
+                        two_players_mode = 0;
+                        practice_mode = 0;
+                        challenge_mode = 1;
+                        name_input_letterCount = 0; name_input_buffer[0] = '\0';
+                        current_screen = GAME_NAME_INPUT_SCREEN;
+                    } else if (menu_index == 4) { // Praticar: direto para o jogo, sem nome
+                        two_players_mode = 0;
+                        practice_mode = 1;
+                        challenge_mode = 0;
+                        sim_start_practice(&sim, 0, SIM_THREADED, PRACTICE_REWIND_SECONDS);
+                        state = sim_latest(&sim, &sim_alpha);
+                        current_screen = GAME_PLAYING;
+                    } else if (menu_index == 5) {
+                        ranking_screen_open(&ranking_screen, ranking, RANKING_MODE_ALL);
+                        current_screen = GAME_RANKING_SCREEN;
+                    }
+                    else if (menu_index == 6) sound_toggle(); // Alterna música
+                    else if (menu_index == 7) exit_requested = 1;
                 }
             } break;
 
@@ -747,9 +1039,17 @@ void raylib_run_game(Ranking *ranking) {
                     if (two_players_mode) {
                         name_input_letterCount = 0; name_input_buffer[0] = '\0';
                         current_screen = GAME_NAME_INPUT_SCREEN_P2;
+                    } else if (challenge_mode) {
+                        // Fantasma lido uma vez aqui; durante a partida só um cursor anda sobre os bytes
+                        challenge_seed = game_daily_seed();
+                        ghost_path(ghost_file, sizeof(ghost_file), RANKING_FILE, challenge_seed);
+                        have_ghost = ghost_load(ghost_file, &challenge_ghost) && challenge_ghost.seed == challenge_seed;
+                        sim_start_challenge(&sim, challenge_seed, have_ghost ? &challenge_ghost : NULL, SIM_THREADED);
+                        state = sim_latest(&sim, &sim_alpha);
+                        current_screen = GAME_PLAYING;
                     } else {
-                        game_init(&state, MAP_WIDTH);
-                        game_set_two_players(&state, 0);
+                        sim_start(&sim, 0, SIM_THREADED);
+                        state = sim_latest(&sim, &sim_alpha);
                         current_screen = GAME_PLAYING;
                     }
                 }
@@ -773,8 +1073,8 @@ void raylib_run_game(Ranking *ranking) {
                 if (IsKeyPressed(KEY_ENTER) && name_input_letterCount > 0) {
                     strncpy(player2_name, name_input_buffer, MAX_NAME_LEN - 1);
                     player2_name[MAX_NAME_LEN - 1] = '\0';
-                    game_init(&state, MAP_WIDTH);
-                    game_set_two_players(&state, 1);
+                    sim_start(&sim, 1, SIM_THREADED);
+                    state = sim_latest(&sim, &sim_alpha);
                     current_screen = GAME_PLAYING;
                 }
                 if (IsKeyPressed(KEY_ESCAPE)) current_screen = GAME_START_SCREEN;
@@ -786,44 +1086,62 @@ void raylib_run_game(Ranking *ranking) {
                     sound_toggle();
                 }
                 
-                if (two_players_mode) {
-                    // P1: WASD
-                    if (IsKeyPressed(KEY_W)) game_handle_input_player(&state, 1, 'W');
-                    if (IsKeyPressed(KEY_S)) game_handle_input_player(&state, 1, 'S');
-                    if (IsKeyPressed(KEY_A)) game_handle_input_player(&state, 1, 'A');
-                    if (IsKeyPressed(KEY_D)) game_handle_input_player(&state, 1, 'D');
-                    
-                    // P2: Setas
-                    if (IsKeyPressed(KEY_UP))    game_handle_input_player(&state, 2, 'W');
-                    if (IsKeyPressed(KEY_DOWN))  game_handle_input_player(&state, 2, 'S');
-                    if (IsKeyPressed(KEY_LEFT))  game_handle_input_player(&state, 2, 'A');
-                    if (IsKeyPressed(KEY_RIGHT)) game_handle_input_player(&state, 2, 'D');
-                } else {
-                    // Modo 1 jogador
-                    if (IsKeyPressed(KEY_W) || IsKeyPressed(KEY_UP))    game_handle_input(&state, 'W');
-                    if (IsKeyPressed(KEY_S) || IsKeyPressed(KEY_DOWN))  game_handle_input(&state, 'S');
-                    if (IsKeyPressed(KEY_A) || IsKeyPressed(KEY_LEFT))  game_handle_input(&state, 'A');
-                    if (IsKeyPressed(KEY_D) || IsKeyPressed(KEY_RIGHT)) game_handle_input(&state, 'D');
+                // Fila de teclas do raylib: todas as teclas do frame, em ordem.
+                // Diferente de IsKeyPressed, dois toques rápidos no mesmo frame viram dois movimentos.
+                double input_time = utils_now_seconds();
+                int key = GetKeyPressed();
+                while (key != 0) {
+                    int player_id;
+                    char move;
+                    if (map_move_key(key, two_players_mode, &player_id, &move)) {
+                        sim_push_input(&sim, player_id, move, input_time);
+                    }
+                    key = GetKeyPressed();
+                }
+
+                // Prática: a volta é aplicada pela simulação no próximo tick
+                if (practice_mode && IsKeyPressed(KEY_BACKSPACE)) {
+                    sim_request_rewind(&sim, PRACTICE_REWIND_STEP);
                 }
 
-                game_update(&state);
+                // A simulação roda na própria thread; aqui só pegamos o snapshot mais novo
+                sim_pump(&sim);
+                state = sim_latest(&sim, &sim_alpha);
 
-                if (state.game_over) {
+                // Na prática o game over não encerra: a simulação espera uma volta no tempo
+                if (state->game_over && !practice_mode) {
+                    sim_stop(&sim);
+                    sim_latency_stats(&sim, &latency);
+                    TraceLog(LOG_INFO, "Latencia entrada->simulacao: %d entradas, p50 %.2f ms, p99 %.2f ms, max %.2f ms (%.2f ticks em media)",
+                             latency.count, latency.p50_ms, latency.p99_ms, latency.max_ms, latency.mean_ticks);
                     if (two_players_mode) {
                         // Salva apenas o melhor score
-                        int p1_score = game_get_player_score(&state, 1);
-                        int p2_score = game_get_player_score(&state, 2);
+                        int p1_score = game_get_player_score(state, 1);
+                        int p2_score = game_get_player_score(state, 2);
                         if (p1_score > p2_score) {
-                            ranking_add(ranking, player_name, p1_score, RANKING_FILE);
+                            ranking_add(ranking, RANKING_MODE_DUO, 0, player_name, p1_score, RANKING_FILE);
                         } else {
-                            ranking_add(ranking, player2_name, p2_score, RANKING_FILE);
+                            ranking_add(ranking, RANKING_MODE_DUO, 0, player2_name, p2_score, RANKING_FILE);
                         }
+                    } else if (challenge_mode) {
+                        ranking_add(ranking, RANKING_MODE_DAILY, challenge_seed, player_name, state->score, RANKING_FILE);
                     } else {
-                        ranking_add(ranking, player_name, state.score, RANKING_FILE);
+                        ranking_add(ranking, RANKING_MODE_SOLO, 0, player_name, state->score, RANKING_FILE);
+                    }
+                    // Desafio: a partida vira o fantasma da semente se bateu o anterior
+                    if (challenge_mode && (!have_ghost || state->score > challenge_ghost.score)) {
+                        if (ghost_run_from_recorder(&challenge_ghost, sim_recording(&sim), challenge_seed,
+                                                    state->score, sim_latest_tick(&sim), player_name)) {
+                            have_ghost = ghost_save(ghost_file, &challenge_ghost);
+                            if (!have_ghost) TraceLog(LOG_WARNING, "Nao foi possivel gravar %s", ghost_file);
+                        }
                     }
                     current_screen = GAME_OVER_SCREEN;
                 }
-                if (IsKeyPressed(KEY_M)) current_screen = GAME_START_SCREEN;
+                if (IsKeyPressed(KEY_M)) {
+                    sim_stop(&sim);
+                    current_screen = GAME_START_SCREEN;
+                }
             } break;
 
             case GAME_OVER_SCREEN: {
@@ -842,16 +1160,51 @@ void raylib_run_game(Ranking *ranking) {
             } break;
 
             case GAME_RANKING_SCREEN: {
-                if (IsKeyPressed(KEY_M)) current_screen = GAME_START_SCREEN;
+                if (ranking_screen_update(&ranking_screen, player_name)) {
+                    ranking_view_close();
+                    current_screen = GAME_START_SCREEN;
+                }
             } break;
         }
 
+        TRACE_END("input");
+        PROF_END(PROF_INPUT);
+        PROF_ADD_MS(PROF_UPDATE, sim_take_update_ms(&sim));
+
         if (exit_requested) break;
 
-        // Desenhar alvo virtual
-        BeginTextureMode(target);
+        float scale, dx, dy;
+        compute_viewport(&scale, &dx, &dy);
+
+        if (direct_render) {
+            // Sem alvo intermediário: libera a textura virtual se ela existir
+            if (target.id != 0) {
+                UnloadRenderTexture(target);
+                target = (RenderTexture2D){0};
+            }
+
+            // Desenha direto no backbuffer, escalando as coordenadas virtuais com a câmera.
+            // O scissor limita os ClearBackground das telas à área do letterbox.
+            BeginDrawing();
+            PROF_BEGIN(PROF_SOUND);
+            sound_update();
+            PROF_END(PROF_SOUND);
+            ClearBackground(BLACK);
+            BeginScissorMode((int)dx, (int)dy, (int)(VIRTUAL_W * scale), (int)(VIRTUAL_H * scale));
+            BeginMode2D((Camera2D){ .offset = {dx, dy}, .target = {0, 0}, .rotation = 0.0f, .zoom = scale });
+        } else {
+            if (target.id == 0) {
+                target = LoadRenderTexture(VIRTUAL_W, VIRTUAL_H);
+                SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+            }
+            // Desenhar alvo virtual
+            BeginTextureMode(target);
+        }
         {
             // desenha como antes, usando SCREEN_WIDTH/HEIGHT fixos
+            // (render_game mede mapa e HUD separadamente; as outras telas contam como HUD)
+            TRACE_BEGIN("draw");
+            if (current_screen != GAME_PLAYING) PROF_BEGIN(PROF_HUD);
             switch (current_screen) {
                 case GAME_START_SCREEN:
                     render_menu_screen(menu_index, MENU_OPTS, MENU_COUNT);
@@ -865,87 +1218,91 @@ void raylib_run_game(Ranking *ranking) {
                     break;
                 case GAME_PLAYING:
                     if (two_players_mode) {
-                        render_game_two(&state);
+                        render_game_two(state, sim_alpha);
                     } else {
-                        render_game(&state);
+                        render_game(state, sim_alpha);
                     }
+                    if (practice_mode) render_practice_hud(sim_rewind_stats(&sim), state->game_over);
+                    if (challenge_mode) render_ghost(state, sim_ghost_view(&sim), &challenge_ghost, sim_alpha);
                     break;
                 case GAME_OVER_SCREEN:
-                    render_game_over_screen(&state, player_name, player2_name, two_players_mode);
+                    render_game_over_screen(state, player_name, player2_name, two_players_mode, &latency, ranking,
+                                            two_players_mode ? RANKING_MODE_DUO
+                                                             : challenge_mode ? RANKING_MODE_DAILY : RANKING_MODE_SOLO);
                     break;
                 case GAME_HELP_SCREEN:
                     render_help_screen();
                     break;
                 case GAME_RANKING_SCREEN:
-                    render_ranking_screen(ranking);
+                    render_ranking_screen(&ranking_screen);
                     break;
             }
+            if (current_screen != GAME_PLAYING) PROF_END(PROF_HUD);
+            TRACE_END("draw");
         }
-        EndTextureMode();
-
-        // Desenhar alvo dimensionado para a tela 
-        BeginDrawing();
-        sound_update();
-        ClearBackground(BLACK);
+        if (direct_render) {
+            EndMode2D();
+            EndScissorMode();
+        } else {
+            PROF_BEGIN(PROF_BLIT);
+            TRACE_BEGIN("blit");
+            EndTextureMode();
+
+            // Desenhar alvo dimensionado para a tela 
+            BeginDrawing();
+            PROF_END(PROF_BLIT);
+            PROF_BEGIN(PROF_SOUND);
+            sound_update();
+            PROF_END(PROF_SOUND);
+            PROF_BEGIN(PROF_BLIT);
+            ClearBackground(BLACK);
 
-        float sw = (float)GetScreenWidth();
-        float sh = (float)GetScreenHeight();
-        float scale = (sw / VIRTUAL_W < sh / VIRTUAL_H) ? (sw / VIRTUAL_W) : (sh / VIRTUAL_H);
-        float dw = VIRTUAL_W * scale;
-        float dh = VIRTUAL_H * scale;
-        float dx = (sw - dw) * 0.5f;
-        float dy = (sh - dh) * 0.5f;
+            DrawTexturePro(
+                target.texture,
+                (Rectangle){0, 0, (float)VIRTUAL_W, -(float)VIRTUAL_H},  // altura negativa = corrige flip
+                (Rectangle){dx, dy, VIRTUAL_W * scale, VIRTUAL_H * scale},
+                (Vector2){0, 0},
+                0.0f,
+                WHITE
+            );
+            TRACE_END("blit");
+            PROF_END(PROF_BLIT);
+        }
 
-        DrawTexturePro(
-            target.texture,
-            (Rectangle){0, 0, (float)VIRTUAL_W, -(float)VIRTUAL_H},  // altura negativa = corrige flip
-            (Rectangle){dx, dy, dw, dh},
-            (Vector2){0, 0},
-            0.0f,
-            WHITE
-        );
+        // Mostra o caminho de renderização por alguns segundos após alternar (F2)
+        if (GetTime() < mode_label_until) {
+            DrawText(TextFormat("Render: %s (%.2f ms)", direct_render ? "direto" : "virtual",
+                                GetFrameTime() * 1000.0f), 10, 10, 20, YELLOW);
+        }
+        // Turbo ligado: mostra a velocidade pedida e os ticks/s que a simulação alcança
+        if (TURBO_SPEEDS[turbo_index] != 1) {
+            double tps = sim_ticks_per_second(&sim, &turbo_rate);
+            const char *label = (TURBO_SPEEDS[turbo_index] == SIM_SPEED_UNBOUNDED)
+                ? TextFormat("Turbo sem limite: %.0f ticks/s (%.0fx)", tps, tps / GAME_TICK_HZ)
+                : TextFormat("Turbo %dx: %.0f ticks/s", TURBO_SPEEDS[turbo_index], tps);
+            DrawText(label, 10, GetScreenHeight() - 30, 20, YELLOW);
+        }
+        PROF_DRAW(10, 40);
+        if (mem_panel_visible) render_mem_panel(GetScreenWidth() - 340, 10);
+        TRACE_BEGIN("present");
         EndDrawing();
+        TRACE_END("present");
+        PROF_FRAME_END(1000.0 / (refresh_hz > 0 ? refresh_hz : 60));
     }
 
     // Descarrega as texturas das sprites para liberar memória
-    if (car_texture.id != 0) {
-        UnloadTexture(car_texture);
-        car_texture = (Texture2D){0};
-    }
-    if (log_texture.id != 0) {
-        UnloadTexture(log_texture);
-        log_texture = (Texture2D){0};
-    }
-    if (bird_texture.id != 0) {
-        UnloadTexture(bird_texture);
-        bird_texture = (Texture2D){0};
-    }
-    if (heart_texture.id != 0) {
-        UnloadTexture(heart_texture);
-        heart_texture = (Texture2D){0};
-    }
-    if (rabbit_texture.id != 0) {
-        UnloadTexture(rabbit_texture);
-        rabbit_texture = (Texture2D){0};
-    }
-    if (menu_texture.id != 0) {
-        UnloadTexture(menu_texture);
-        menu_texture = (Texture2D){0};
-    }
-    if (grass_texture.id != 0) {
-        UnloadTexture(grass_texture);
-        grass_texture = (Texture2D){0};
-    }
-    if (river_texture.id != 0) {
-        UnloadTexture(river_texture);
-        river_texture = (Texture2D){0};
-    }
-    if (road_texture.id != 0) {
-        UnloadTexture(road_texture);
-        road_texture = (Texture2D){0};
-    }
-
-    UnloadRenderTexture(target);
+    unload_tracked_texture(&car_texture);
+    unload_tracked_texture(&log_texture);
+    unload_tracked_texture(&bird_texture);
+    unload_tracked_texture(&heart_texture);
+    unload_tracked_texture(&rabbit_texture);
+    unload_tracked_texture(&menu_texture);
+    unload_tracked_texture(&grass_texture);
+    unload_tracked_texture(&river_texture);
+    unload_tracked_texture(&road_texture);
+
+    sim_release(&sim);
+    if (target.id != 0) UnloadRenderTexture(target);
     sound_close();
     CloseWindow();
 }
@@ -970,44 +1327,202 @@ static void render_help_screen(void) {
     DrawText(menu_back_text, SCREEN_WIDTH/2 - menu_back_width/2, y, 18, GRAY);
 }
 
-static void render_ranking_screen(const Ranking *ranking) {
-    ClearBackground(BLACK);
-    DrawText("Ranking", SCREEN_WIDTH/2 - 70, 80, 32, YELLOW);
-    const char *menu_ranking_text = "'M' para voltar ao menu";
-    int menu_ranking_width = MeasureText(menu_ranking_text, 20);
-    DrawText(menu_ranking_text, SCREEN_WIDTH/2 - menu_ranking_width/2, 120, 20, GRAY);
+/* -------------------------------------------------------
+   TELA DE RANKING
+ ------------------------------------------------------- */
+static void ranking_screen_set_status(RankingScreen *screen) {
+    char a[16], b[16], n[16];
+    format_count(a, sizeof(a), screen->first + 1);
+    format_count(b, sizeof(b), screen->first + (uint32_t)screen->row_count);
+    format_count(n, sizeof(n), screen->total);
+    snprintf(screen->status, sizeof(screen->status), "%s-%s de %s", a, b, n);
+}
 
-    int x = SCREEN_WIDTH/2 - 200;
-    int y = 170;
-    int lh = 35;  // Aumentado o espaçamento entre linhas
+// Relê e formata a janela só quando ela muda
+static void ranking_screen_fill(RankingScreen *screen) {
+    if (screen->first == screen->cached_first) return;
+    RankingRow rows[RANKING_PAGE_ROWS];
+    screen->row_count = ranking_view_rows(screen->first, rows, RANKING_PAGE_ROWS);
+    for (int i = 0; i < screen->row_count; ++i) {
+        RankingScreenRow *r = &screen->rows[i];
+        char place[16];
+        r->row = rows[i];
+        format_count(place, sizeof(place), rows[i].place);
+        snprintf(r->place, sizeof(r->place), "#%s", place);
+        snprintf(r->score, sizeof(r->score), "%d", rows[i].score);
+        r->score_width = MeasureText(r->score, 24);
+    }
+    screen->cached_first = screen->first;
+    ranking_screen_set_status(screen);
+}
 
-    int maxShow = 10;
-    int n = 0;
+// Rola até a linha (clampada), com ela na primeira posição se possível
+static void ranking_screen_scroll_to(RankingScreen *screen, long long row) {
+    long long last_first = (long long)screen->total - RANKING_PAGE_ROWS;
+    if (row > last_first) row = last_first;
+    if (row < 0) row = 0;
+    screen->first = (uint32_t)row;
+    ranking_screen_fill(screen);
+}
 
-    // Cabeçalho das colunas
-    DrawText("Nome", x + 80, y, 22, LIGHTGRAY);
-    DrawText("Pontuação", x + 280, y, 22, LIGHTGRAY);
-    y += lh + 5;  // Espaço extra após o cabeçalho
-    
-    DrawLine(x - 10, y - 5, x + 380, y - 5, GRAY);     // Linha separadora
+static void ranking_screen_jump(RankingScreen *screen, const RankingMatch *match) {
+    if (match->runs == 0) {
+        snprintf(screen->status, sizeof(screen->status), "%s ainda nao tem partidas", match->name);
+        return;
+    }
+    screen->highlight = ranking_view_row_of_player(match->name, match->best);
+    ranking_screen_scroll_to(screen, (long long)screen->highlight - RANKING_PAGE_ROWS / 2);
+    ranking_screen_set_status(screen);
+}
+
+static void ranking_screen_search(RankingScreen *screen) {
+    screen->match_count = ranking_view_find(screen->query, screen->matches, RANKING_MATCHES_SHOWN, &screen->match_total);
+    screen->match_index = 0;
+    for (int i = 0; i < screen->match_count; ++i) {
+        const RankingMatch *m = &screen->matches[i];
+        char place[16];
+        format_count(place, sizeof(place), m->row + 1);
+        if (m->runs) snprintf(screen->match_text[i], sizeof(screen->match_text[i]), "%s  (recorde %d, #%s)", m->name, m->best, place);
+        else snprintf(screen->match_text[i], sizeof(screen->match_text[i]), "%s", m->name);
+    }
+}
+
+// Abre a tela: placar inteiro sob demanda (ou o top-K de um modo), começando do topo
+static void ranking_screen_open(RankingScreen *screen, const Ranking *ranking, RankingMode mode) {
+    memset(screen, 0, sizeof(*screen));
+    screen->ranking = ranking;
+    screen->mode = mode;
+    screen->total = ranking_view_open(ranking, mode, RANKING_FILE);
+    char n[16];
+    format_count(n, sizeof(n), mode == RANKING_MODE_ALL ? screen->total : ranking_total_runs(ranking, mode));
+    snprintf(screen->total_text, sizeof(screen->total_text), "%s | %s partidas", ranking_mode_name(mode), n);
+    screen->cached_first = UINT32_MAX;
+    screen->highlight = UINT32_MAX;
+    ranking_screen_scroll_to(screen, 0);
+}
 
-    for (int i = 0; i < ranking->count && n < maxShow; ++i) {
-        const char* name = ranking->items[i].name;
-        int score = ranking->items[i].score;
+/**
+ * Teclado da tela de ranking
+ * Lista: setas/PgUp/PgDn/roda do mouse rolam, Home/End, P = minha posição, B = buscar, TAB = próximo modo, M = menu.
+ * Busca: digitar filtra por prefixo, setas escolhem, ENTER vai até o jogador, ESC fecha.
+ * @param player_name Último jogador (para "minha posição"); pode ser vazio
+ * @return 1 para voltar ao menu
+ */
+static int ranking_screen_update(RankingScreen *screen, const char *player_name) {
+    if (screen->searching) {
+        int changed = 0;
+        int key = GetCharPressed();
+        while (key > 0) {
+            if (key >= 32 && key <= 125 && screen->query_len < MAX_NAME_LEN - 1) {
+                screen->query[screen->query_len++] = (char)key;
+                screen->query[screen->query_len] = '\0';
+                changed = 1;
+            }
+            key = GetCharPressed();
+        }
+        if (IsKeyPressed(KEY_BACKSPACE) && screen->query_len > 0) {
+            screen->query[--screen->query_len] = '\0';
+            changed = 1;
+        }
+        if (changed) ranking_screen_search(screen);
+        if (IsKeyPressed(KEY_DOWN) && screen->match_index < screen->match_count - 1) screen->match_index++;
+        if (IsKeyPressed(KEY_UP) && screen->match_index > 0) screen->match_index--;
+        if (IsKeyPressed(KEY_ENTER) && screen->match_count > 0) {
+            ranking_screen_jump(screen, &screen->matches[screen->match_index]);
+            screen->searching = 0;
+        }
+        if (IsKeyPressed(KEY_ESCAPE)) screen->searching = 0;
+        return 0;
+    }
 
-        DrawText(TextFormat("%2d.", i + 1), x, y, 24, WHITE); // Posição (mais espaçada)
+    long long row = screen->first;
+    if (IsKeyPressed(KEY_DOWN)) row += 1;
+    if (IsKeyPressed(KEY_UP)) row -= 1;
+    if (IsKeyPressed(KEY_PAGE_DOWN)) row += RANKING_PAGE_ROWS;
+    if (IsKeyPressed(KEY_PAGE_UP)) row -= RANKING_PAGE_ROWS;
+    if (IsKeyPressed(KEY_HOME)) row = 0;
+    if (IsKeyPressed(KEY_END)) row = screen->total;
+    row -= (long long)(GetMouseWheelMove() * RANKING_WHEEL_ROWS);
+    if (row != (long long)screen->first) ranking_screen_scroll_to(screen, row);
+
+    if (IsKeyPressed(KEY_P)) {
+        RankingMatch me;
+        uint32_t total;
+        if (player_name && player_name[0] && ranking_view_find(player_name, &me, 1, &total) == 1 &&
+            strcmp(me.name, player_name) == 0) {
+            ranking_screen_jump(screen, &me);
+        } else {
+            snprintf(screen->status, sizeof(screen->status), "Jogue uma partida para ver sua posicao");
+        }
+    }
+    if (IsKeyPressed(KEY_B)) {
+        screen->searching = 1;
+        screen->query_len = 0;
+        screen->query[0] = '\0';
+        ranking_screen_search(screen);
+    }
+    if (IsKeyPressed(KEY_TAB)) {
+        RankingMode next = (RankingMode)(screen->mode + 1);
+        if (next >= RANKING_MODE_COUNT) next = RANKING_MODE_ALL;
+        ranking_screen_open(screen, screen->ranking, next);
+    }
+    return IsKeyPressed(KEY_M);
+}
 
-        DrawText(name, x + 80, y, 24, WHITE);  // Nome (com mais espaço)
+static void render_ranking_screen(const RankingScreen *screen) {
+    ClearBackground(BLACK);
+    DrawText("Ranking", SCREEN_WIDTH/2 - 70, 30, 32, YELLOW);
+    int total_width = MeasureText(screen->total_text, 18);
+    DrawText(screen->total_text, SCREEN_WIDTH/2 - total_width/2, 70, 18, GRAY);
+
+    int x = SCREEN_WIDTH/2 - 220;
+    int y = 105;
+    int lh = 32;
+
+    if (screen->searching) {
+        DrawRectangle(x - 10, y, 460, 40, (Color){60, 60, 60, 255});
+        DrawRectangleLines(x - 10, y, 460, 40, WHITE);
+        DrawText("Buscar:", x, y + 10, 22, LIGHTGRAY);
+        DrawText(screen->query, x + 90, y + 10, 22, WHITE);
+        if (((int)(GetTime() * 2)) % 2 == 0) DrawText("_", x + 90 + MeasureText(screen->query, 22), y + 10, 22, WHITE);
+        y += 60;
+        for (int i = 0; i < screen->match_count; ++i) {
+            Color c = (i == screen->match_index) ? YELLOW : WHITE;
+            if (i == screen->match_index) DrawText(">", x - 5, y, 22, c);
+            DrawText(screen->match_text[i], x + 20, y, 22, c);
+            y += lh;
+        }
+        if (screen->match_count == 0) DrawText("Nenhum jogador com esse nome.", x + 20, y, 22, GRAY);
+        else if (screen->match_total > (uint32_t)screen->match_count) {
+            DrawText(TextFormat("... e mais %u", (unsigned)(screen->match_total - (uint32_t)screen->match_count)),
+                     x + 20, y, 18, GRAY);
+        }
+        const char *hint = "Setas: escolher | ENTER: ir ate o jogador | ESC: fechar";
+        DrawText(hint, SCREEN_WIDTH/2 - MeasureText(hint, 18)/2, SCREEN_HEIGHT - 40, 18, GRAY);
+        return;
+    }
 
-        // Pontuação 
-        const char* scoreText = TextFormat("%d", score);
-        int scoreWidth = MeasureText(scoreText, 24);
-        DrawText(scoreText, x + 380 - scoreWidth, y, 24, YELLOW);
-        
+    // Cabeçalho das colunas
+    DrawText("#", x, y, 22, LIGHTGRAY);
+    DrawText("Nome", x + 110, y, 22, LIGHTGRAY);
+    DrawText("Pontuação", x + 330, y, 22, LIGHTGRAY);
+    y += lh + 5;
+    DrawLine(x - 10, y - 5, x + 450, y - 5, GRAY);     // Linha separadora
+
+    for (int i = 0; i < screen->row_count; ++i) {
+        const RankingScreenRow *r = &screen->rows[i];
+        int marked = screen->first + (uint32_t)i == screen->highlight;
+        if (marked) DrawRectangle(x - 10, y - 4, 460, lh, Fade(YELLOW, 0.25f));
+        DrawText(r->place, x, y, 24, WHITE);
+        DrawText(r->row.name, x + 110, y, 24, WHITE);
+        DrawText(r->score, x + 440 - r->score_width, y, 24, YELLOW);
         y += lh;
-        n++;
     }
-    if (n == 0) {
+    if (screen->row_count == 0) {
         DrawText("Nenhum registro encontrado ainda.", SCREEN_WIDTH/2 - 180, y, 22, GRAY);
     }
-}
\ No newline at end of file
+
+    DrawText(screen->status, x, SCREEN_HEIGHT - 80, 18, SKYBLUE);
+    const char *hint = "Setas/PgUp/PgDn/roda: rolar | Home/End | P: minha posicao | B: buscar | TAB: modo | M: menu";
+    DrawText(hint, SCREEN_WIDTH/2 - MeasureText(hint, 16)/2, SCREEN_HEIGHT - 40, 16, GRAY);
+}
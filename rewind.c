@@ -0,0 +1,425 @@
+#include "rewind.h"
+#include "mem.h"
+#include "utils.h"
+#include <string.h>
+
+// Pior caso do codificador: tudo literal + cabeçalhos de algumas corridas
+#define REWIND_MAX_ENCODED (REWIND_STATE_BYTES + 16)
+// Corridas de bytes iguais menores que isso ficam dentro do literal (não compensa o cabeçalho)
+#define REWIND_MIN_ZERO_RUN 3
+
+/* -------------------------------------------------------
+   SERIALIZAÇÃO DO ESTADO
+   - Campo a campo, inteiros em 32 bits little-endian e as
+     células de cada fila a partir do head. Tamanho fixo para
+     a mesma posição sempre ser o mesmo campo (o delta depende disso).
+ ------------------------------------------------------- */
+static unsigned char *put_i32(unsigned char *p, int v)
+{
+    unsigned int u = (unsigned int)v;
+    p[0] = (unsigned char)u; p[1] = (unsigned char)(u >> 8);
+    p[2] = (unsigned char)(u >> 16); p[3] = (unsigned char)(u >> 24);
+    return p + 4;
+}
+
+static const unsigned char *get_i32(const unsigned char *p, int *v)
+{
+    *v = (int)((unsigned int)p[0] | ((unsigned int)p[1] << 8) |
+               ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24));
+    return p + 4;
+}
+
+static unsigned char *put_player(unsigned char *p, const Player *pl)
+{
+    p = put_i32(p, pl->x);
+    p = put_i32(p, pl->y);
+    p = put_i32(p, pl->alive);
+    p = put_i32(p, pl->score);
+    p = put_i32(p, pl->min_abs_reached);
+    p = put_i32(p, pl->last_abs);
+    return put_i32(p, pl->advanced_this_tick);
+}
+
+static const unsigned char *get_player(const unsigned char *p, Player *pl)
+{
+    p = get_i32(p, &pl->x);
+    p = get_i32(p, &pl->y);
+    p = get_i32(p, &pl->alive);
+    p = get_i32(p, &pl->score);
+    p = get_i32(p, &pl->min_abs_reached);
+    p = get_i32(p, &pl->last_abs);
+    return get_i32(p, &pl->advanced_this_tick);
+}
+
+static void state_pack(const GameState *s, unsigned char *out)
+{
+    memset(out, 0, REWIND_STATE_BYTES);
+    unsigned char *p = out;
+
+    for (int y = 0; y <= MAP_HEIGHT; ++y) {
+        const Row *row = y < MAP_HEIGHT ? &s->rows[y] : &s->incoming;
+        p = put_i32(p, row->type);
+        p = put_i32(p, row->direction);
+        p = put_i32(p, row->speed_ticks);
+        p = put_i32(p, row->tick_counter);
+        p = put_i32(p, row->moved_this_tick);
+
+        const Node *n = row->queue ? row->queue->head : NULL;
+        for (int x = 0; x < MAP_WIDTH; ++x) {
+            *p++ = n ? (unsigned char)n->data : ' ';
+            if (n) n = n->next;
+        }
+    }
+
+    int timer_bits;
+    memcpy(&timer_bits, &s->renascer_timer, sizeof(timer_bits));
+
+    p = put_i32(p, s->player_x);
+    p = put_i32(p, s->player_y);
+    p = put_i32(p, s->score);
+    p = put_i32(p, s->game_over);
+    p = put_i32(p, s->world_position);
+    p = put_i32(p, s->just_scrolled);
+    p = put_i32(p, s->scroll_timer);
+    p = put_i32(p, s->world_head);
+    p = put_i32(p, s->min_abs_reached);
+    p = put_i32(p, s->last_abs);
+    p = put_i32(p, s->advanced_this_tick);
+    p = put_i32(p, s->vidas);
+    p = put_i32(p, s->renascendo);
+    p = put_i32(p, timer_bits);
+    p = put_i32(p, s->life_power_spawned);
+    p = put_player(p, &s->p1);
+    p = put_player(p, &s->p2);
+    p = put_i32(p, s->two_players);
+    p = put_i32(p, (int)s->seed);
+    put_i32(p, (int)s->rng);
+}
+
+// Restaura em dst reaproveitando as filas que ele já tem
+static int state_unpack(GameState *dst, const unsigned char *in)
+{
+    const unsigned char *p = in;
+
+    for (int y = 0; y <= MAP_HEIGHT; ++y) {
+        Row *row = y < MAP_HEIGHT ? &dst->rows[y] : &dst->incoming;
+        int type;
+        p = get_i32(p, &type);
+        row->type = (RowType)type;
+        p = get_i32(p, &row->direction);
+        p = get_i32(p, &row->speed_ticks);
+        p = get_i32(p, &row->tick_counter);
+        p = get_i32(p, &row->moved_this_tick);
+
+        if (row->queue && row->queue->length != MAP_WIDTH) {
+            queue_destroy(row->queue);
+            row->queue = NULL;
+        }
+        if (!row->queue) row->queue = queue_create(MAP_WIDTH);
+        if (!row->queue) return 0;
+        queue_set_cells(row->queue, (const char *)p, MAP_WIDTH, 0);
+        p += MAP_WIDTH;
+    }
+
+    int timer_bits, seed, rng;
+    p = get_i32(p, &dst->player_x);
+    p = get_i32(p, &dst->player_y);
+    p = get_i32(p, &dst->score);
+    p = get_i32(p, &dst->game_over);
+    p = get_i32(p, &dst->world_position);
+    p = get_i32(p, &dst->just_scrolled);
+    p = get_i32(p, &dst->scroll_timer);
+    p = get_i32(p, &dst->world_head);
+    p = get_i32(p, &dst->min_abs_reached);
+    p = get_i32(p, &dst->last_abs);
+    p = get_i32(p, &dst->advanced_this_tick);
+    p = get_i32(p, &dst->vidas);
+    p = get_i32(p, &dst->renascendo);
+    p = get_i32(p, &timer_bits);
+    p = get_i32(p, &dst->life_power_spawned);
+    p = get_player(p, &dst->p1);
+    p = get_player(p, &dst->p2);
+    p = get_i32(p, &dst->two_players);
+    p = get_i32(p, &seed);
+    get_i32(p, &rng);
+
+    memcpy(&dst->renascer_timer, &timer_bits, sizeof(timer_bits));
+    dst->seed = (unsigned int)seed;
+    dst->rng = (unsigned int)rng;
+    return 1;
+}
+
+/* -------------------------------------------------------
+   DELTA: XOR contra a base + RLE dos zeros
+   - Formato: [corrida de zeros][tamanho do literal][literal...]
+     repetido, com os números em varint.
+ ------------------------------------------------------- */
+static unsigned char *put_varint(unsigned char *p, int v)
+{
+    while (v >= 0x80) {
+        *p++ = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (unsigned char)v;
+    return p;
+}
+
+static const unsigned char *get_varint(const unsigned char *p, const unsigned char *end, int *v)
+{
+    int value = 0, shift = 0;
+    while (p < end) {
+        unsigned char b = *p++;
+        value |= (b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *v = value;
+            return p;
+        }
+        shift += 7;
+    }
+    *v = 0;
+    return end;
+}
+
+// base NULL = keyframe (delta contra zeros). Retorna o tamanho codificado
+static int delta_encode(const unsigned char *cur, const unsigned char *base, unsigned char *out)
+{
+    unsigned char *p = out;
+    int i = 0;
+    while (i < REWIND_STATE_BYTES) {
+        int zeros = 0;
+        while (i + zeros < REWIND_STATE_BYTES && cur[i + zeros] == (base ? base[i + zeros] : 0)) zeros++;
+        if (i + zeros == REWIND_STATE_BYTES) break;          // resto igual: fim
+
+        // Literal até achar uma corrida de iguais que valha a pena cortar
+        int start = i + zeros, end = start, same = 0;
+        while (end < REWIND_STATE_BYTES && same < REWIND_MIN_ZERO_RUN) {
+            same = (cur[end] == (base ? base[end] : 0)) ? same + 1 : 0;
+            end++;
+        }
+        if (same >= REWIND_MIN_ZERO_RUN) end -= same;
+
+        p = put_varint(p, zeros);
+        p = put_varint(p, end - start);
+        for (int k = start; k < end; ++k) *p++ = (unsigned char)(cur[k] ^ (base ? base[k] : 0));
+        i = end;
+    }
+    return (int)(p - out);
+}
+
+// Aplica o delta sobre state (que deve conter a base)
+static void delta_apply(unsigned char *state, const unsigned char *data, int length)
+{
+    const unsigned char *p = data, *end = data + length;
+    int i = 0;
+    while (p < end) {
+        int zeros, lit;
+        p = get_varint(p, end, &zeros);
+        p = get_varint(p, end, &lit);
+        i += zeros;
+        for (int k = 0; k < lit && p < end && i < REWIND_STATE_BYTES; ++k) state[i++] ^= *p++;
+    }
+}
+
+/* -------------------------------------------------------
+   ANEL DE CHECKPOINTS
+ ------------------------------------------------------- */
+static RewindCheckpoint *cp_at(RewindBuffer *rb, int i)
+{
+    return &rb->checkpoints[(rb->cp_first + i) % REWIND_MAX_CHECKPOINTS];
+}
+
+static void drop_oldest_inputs(RewindBuffer *rb)
+{
+    // Entradas até o checkpoint mais antigo não são mais necessárias para re-simular
+    unsigned oldest = rb->cp_count > 0 ? cp_at(rb, 0)->tick : 0xFFFFFFFFu;
+    while (rb->in_count > 0 && rb->inputs[rb->in_first].tick <= oldest) {
+        rb->in_first = (rb->in_first + 1) % REWIND_MAX_INPUTS;
+        rb->in_count--;
+    }
+}
+
+// Remove o mais antigo e os deltas que dependiam dele (até o próximo keyframe)
+static void evict_oldest(RewindBuffer *rb)
+{
+    if (rb->cp_count == 0) return;
+    do {
+        rb->cp_first = (rb->cp_first + 1) % REWIND_MAX_CHECKPOINTS;
+        rb->cp_count--;
+    } while (rb->cp_count > 0 && !cp_at(rb, 0)->keyframe);
+    if (rb->cp_count == 0) rb->have_last = 0;   // sem base: o próximo precisa ser keyframe
+    drop_oldest_inputs(rb);
+}
+
+static int ranges_overlap(int a, int a_len, int b, int b_len)
+{
+    return a < b + b_len && b < a + a_len;
+}
+
+// Reserva length bytes na arena, expulsando o que estiver no caminho
+static int arena_reserve(RewindBuffer *rb, int length)
+{
+    if (rb->write_pos + length > REWIND_ARENA_BYTES) rb->write_pos = 0;
+    int at = rb->write_pos;
+    while (rb->cp_count > 0 && ranges_overlap(at, length, cp_at(rb, 0)->offset, cp_at(rb, 0)->length)) {
+        evict_oldest(rb);
+    }
+    rb->write_pos = at + length;
+    return at;
+}
+
+/* -------------------------------------------------------
+   API
+ ------------------------------------------------------- */
+int rewind_init(RewindBuffer *rb, int max_seconds)
+{
+    if (!rb) return 0;
+    if (!rb->arena) rb->arena = (unsigned char *)mem_alloc(MEM_REWIND, REWIND_ARENA_BYTES);
+    if (!rb->arena) return 0;
+    rb->max_ticks = (unsigned)(max_seconds > 0 ? max_seconds : 1) * GAME_TICK_HZ;
+    rewind_clear(rb);
+    return 1;
+}
+
+void rewind_free(RewindBuffer *rb)
+{
+    if (!rb) return;
+    mem_free(MEM_REWIND, rb->arena, REWIND_ARENA_BYTES);
+    rb->arena = NULL;
+}
+
+void rewind_clear(RewindBuffer *rb)
+{
+    if (!rb) return;
+    rb->write_pos = 0;
+    rb->cp_first = rb->cp_count = 0;
+    rb->since_keyframe = 0;
+    rb->in_first = rb->in_count = 0;
+    rb->have_last = 0;
+    rb->checkpoint_seconds = 0.0;
+    rb->checkpoints_taken = 0;
+    rb->last_restore_ms = 0.0;
+}
+
+void rewind_record_input(RewindBuffer *rb, unsigned tick, int player_id, char key)
+{
+    if (!rb || !rb->arena) return;
+    if (rb->in_count == REWIND_MAX_INPUTS) {
+        // Sem espaço: a entrada mais antiga sai e, com ela, os checkpoints que precisariam dela
+        unsigned dropped = rb->inputs[rb->in_first].tick;
+        rb->in_first = (rb->in_first + 1) % REWIND_MAX_INPUTS;
+        rb->in_count--;
+        while (rb->cp_count > 0 && cp_at(rb, 0)->tick < dropped) evict_oldest(rb);
+    }
+    rb->inputs[(rb->in_first + rb->in_count) % REWIND_MAX_INPUTS] = (RewindInput){ tick, player_id, key };
+    rb->in_count++;
+}
+
+void rewind_after_tick(RewindBuffer *rb, const GameState *state, unsigned tick)
+{
+    if (!rb || !rb->arena || !state || tick % REWIND_CHECKPOINT_TICKS != 0) return;
+    double t0 = utils_now_seconds();
+
+    // Janela de tempo e número de checkpoints limitados
+    while (rb->cp_count > 0 && tick - cp_at(rb, 0)->tick > rb->max_ticks) evict_oldest(rb);
+    if (rb->cp_count == REWIND_MAX_CHECKPOINTS) evict_oldest(rb);
+
+    unsigned char packed[REWIND_STATE_BYTES];
+    unsigned char encoded[REWIND_MAX_ENCODED];
+    state_pack(state, packed);
+
+    int keyframe = !rb->have_last || rb->since_keyframe >= REWIND_KEYFRAME_EVERY;
+    int length = delta_encode(packed, keyframe ? NULL : rb->last_packed, encoded);
+
+    int offset = arena_reserve(rb, length);
+    // Reservar pode ter expulsado tudo (inclusive a base do delta): vira keyframe
+    if (!keyframe && rb->cp_count == 0) {
+        keyframe = 1;
+        length = delta_encode(packed, NULL, encoded);
+        offset = arena_reserve(rb, length);
+    }
+    memcpy(rb->arena + offset, encoded, (size_t)length);
+
+    *cp_at(rb, rb->cp_count) = (RewindCheckpoint){ tick, offset, length, keyframe };
+    rb->cp_count++;
+    rb->since_keyframe = keyframe ? 1 : rb->since_keyframe + 1;
+    memcpy(rb->last_packed, packed, sizeof(packed));
+    rb->have_last = 1;
+
+    rb->checkpoint_seconds += utils_now_seconds() - t0;
+    rb->checkpoints_taken++;
+}
+
+int rewind_to(RewindBuffer *rb, GameState *state, unsigned *tick)
+{
+    if (!rb || !rb->arena || !state || !tick || rb->cp_count == 0) return 0;
+    double t0 = utils_now_seconds();
+    unsigned target_tick = *tick;
+
+    // Checkpoint mais novo com tick <= alvo (ou o mais antigo, se o alvo já saiu da janela)
+    int idx = 0;
+    for (int i = rb->cp_count - 1; i >= 0; --i) {
+        if (cp_at(rb, i)->tick <= target_tick) {
+            idx = i;
+            break;
+        }
+    }
+    if (cp_at(rb, idx)->tick > target_tick) target_tick = cp_at(rb, idx)->tick;
+
+    // Decodifica do keyframe do grupo até ele
+    int key = idx;
+    while (key > 0 && !cp_at(rb, key)->keyframe) key--;
+    unsigned char packed[REWIND_STATE_BYTES];
+    memset(packed, 0, sizeof(packed));
+    for (int i = key; i <= idx; ++i) {
+        const RewindCheckpoint *cp = cp_at(rb, i);
+        delta_apply(packed, rb->arena + cp->offset, cp->length);
+    }
+    if (!state_unpack(state, packed)) return 0;
+
+    // Re-simula até o alvo com as entradas gravadas (mesma ordem do tick da simulação)
+    unsigned from = cp_at(rb, idx)->tick;
+    int in = 0;
+    while (in < rb->in_count && rb->inputs[(rb->in_first + in) % REWIND_MAX_INPUTS].tick <= from) in++;
+    for (unsigned t = from + 1; t <= target_tick; ++t) {
+        while (in < rb->in_count) {
+            const RewindInput *ev = &rb->inputs[(rb->in_first + in) % REWIND_MAX_INPUTS];
+            if (ev->tick != t) break;
+            if (ev->player_id == 0) game_handle_input(state, ev->key);
+            else                    game_handle_input_player(state, ev->player_id, ev->key);
+            in++;
+        }
+        if (!state->game_over) game_update(state);
+    }
+
+    // O futuro descartado: checkpoints depois do alvo e entradas depois dele
+    rb->cp_count = idx + 1;
+    rb->in_count = in;
+    rb->write_pos = cp_at(rb, idx)->offset + cp_at(rb, idx)->length;
+    rb->have_last = 0;          // próximo checkpoint começa um grupo novo
+
+    rb->last_restore_ms = (utils_now_seconds() - t0) * 1000.0;
+    *tick = target_tick;
+    return 1;
+}
+
+void rewind_stats(const RewindBuffer *rb, RewindStats *out)
+{
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!rb) return;
+
+    int bytes = 0;
+    for (int i = 0; i < rb->cp_count; ++i) {
+        bytes += rb->checkpoints[(rb->cp_first + i) % REWIND_MAX_CHECKPOINTS].length;
+    }
+    out->checkpoints = rb->cp_count;
+    out->bytes_used = bytes;
+    if (rb->cp_count > 0) {
+        unsigned first = rb->checkpoints[rb->cp_first].tick;
+        unsigned last = rb->checkpoints[(rb->cp_first + rb->cp_count - 1) % REWIND_MAX_CHECKPOINTS].tick;
+        out->history_seconds = (double)(last - first) / GAME_TICK_HZ;
+    }
+    if (out->history_seconds > 0.0) out->bytes_per_minute = bytes / out->history_seconds * 60.0;
+    out->last_restore_ms = rb->last_restore_ms;
+    if (rb->checkpoints_taken > 0) out->checkpoint_us = rb->checkpoint_seconds * 1e6 / rb->checkpoints_taken;
+}
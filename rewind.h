@@ -0,0 +1,93 @@
+#ifndef REWIND_H
+#define REWIND_H
+
+#include "game.h"
+
+// Histórico para o modo prática: checkpoints compactos do GameState + as entradas entre eles.
+// Voltar no tempo = restaurar o checkpoint mais próximo e re-simular até o tick pedido.
+//
+// - Um checkpoint a cada REWIND_CHECKPOINT_TICKS ticks, codificado como delta (XOR + RLE dos
+//   bytes iguais) contra o anterior; a cada REWIND_KEYFRAME_EVERY vem um completo.
+// - Tudo fica numa arena de bytes de tamanho fixo usada como anel: a memória nunca cresce,
+//   os checkpoints mais antigos (um grupo keyframe+deltas por vez) saem para dar lugar.
+
+#define REWIND_CHECKPOINT_TICKS 10
+#define REWIND_KEYFRAME_EVERY 16
+#define REWIND_ARENA_BYTES (256 * 1024)
+#define REWIND_MAX_CHECKPOINTS 1024
+#define REWIND_MAX_INPUTS 2048
+
+// Estado serializado: por linha (as visíveis + a que está entrando) 5 inteiros + células; mais os escalares (com folga)
+#define REWIND_STATE_BYTES ((MAP_HEIGHT + 1) * (5 * 4 + MAP_WIDTH) + 64 * 4)
+
+typedef struct RewindCheckpoint {
+    unsigned tick;
+    int offset;         // posição na arena
+    int length;         // bytes codificados
+    int keyframe;       // 1 = delta contra zeros (não depende dos anteriores)
+} RewindCheckpoint;
+
+typedef struct RewindInput {
+    unsigned tick;      // tick em que a entrada foi aplicada
+    int player_id;
+    char key;
+} RewindInput;
+
+typedef struct RewindStats {
+    double history_seconds;     // quanto dá para voltar agora
+    int bytes_used;             // bytes codificados na arena
+    double bytes_per_minute;    // custo de memória por minuto de histórico
+    int checkpoints;
+    double last_restore_ms;     // restaurar + re-simular na última volta
+    double checkpoint_us;       // custo médio de um checkpoint
+} RewindStats;
+
+typedef struct RewindBuffer {
+    unsigned char *arena;
+    int write_pos;
+    unsigned max_ticks;         // não guarda mais que isso de histórico
+
+    RewindCheckpoint checkpoints[REWIND_MAX_CHECKPOINTS];
+    int cp_first, cp_count;     // anel: mais antigo em cp_first
+    int since_keyframe;
+
+    RewindInput inputs[REWIND_MAX_INPUTS];
+    int in_first, in_count;
+
+    unsigned char last_packed[REWIND_STATE_BYTES];  // base do próximo delta
+    int have_last;
+
+    // Instrumentação
+    double checkpoint_seconds;
+    long checkpoints_taken;
+    double last_restore_ms;
+} RewindBuffer;
+
+/**
+ * Aloca a arena e limpa o histórico
+ * @param max_seconds Janela máxima de volta no tempo
+ * @return 0 se faltou memória
+ */
+int rewind_init(RewindBuffer *rb, int max_seconds);
+void rewind_free(RewindBuffer *rb);
+void rewind_clear(RewindBuffer *rb);
+
+// Registra uma entrada aplicada no tick (na ordem em que foi aplicada)
+void rewind_record_input(RewindBuffer *rb, unsigned tick, int player_id, char key);
+
+// Chamar depois do game_update de cada tick; só grava nos múltiplos de REWIND_CHECKPOINT_TICKS
+void rewind_after_tick(RewindBuffer *rb, const GameState *state, unsigned tick);
+
+/**
+ * Volta o estado para o tick pedido (ou o mais antigo disponível)
+ * Restaura o checkpoint mais próximo antes do alvo, re-simula com as entradas gravadas
+ * e descarta o histórico posterior.
+ * @param state Estado vivo (as filas dele são reaproveitadas)
+ * @param tick Entrada: tick alvo. Saída: tick em que o estado ficou
+ * @return 0 se não havia histórico (estado intocado)
+ */
+int rewind_to(RewindBuffer *rb, GameState *state, unsigned *tick);
+
+void rewind_stats(const RewindBuffer *rb, RewindStats *out);
+
+#endif // REWIND_H
@@ -0,0 +1,405 @@
+#include "sim.h"
+#include "trace.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_FRESH 4            // bit em middle: snapshot novo ainda não lido
+#define SIM_MAX_LAG 0.25       // segundos de atraso antes de ressincronizar o relógio
+#define SIM_TURBO_SLICE 0.008  // turbo sem limite: publica um snapshot a cada fatia de 8 ms
+
+static const double SIM_DT = 1.0 / GAME_TICK_HZ;
+
+/* -------------------------------------------------------
+   TRIPLE BUFFER
+   - Escritor copia em back e troca com middle.
+   - Leitor, se middle tem SIM_FRESH, troca front com middle.
+   - Os dois lados nunca tocam o mesmo buffer ao mesmo tempo.
+ ------------------------------------------------------- */
+static void sim_publish(Sim *sim, double now)
+{
+    game_copy_state(&sim->buffers[sim->back], &sim->live);
+    sim->published_at[sim->back] = now;
+    sim->published_tick[sim->back] = sim->tick;
+    if (sim->practice) rewind_stats(&sim->rewind, &sim->rewind_published[sim->back]);
+    if (sim->ghost_active) {
+        const GameState *g = &sim->ghost;
+        sim->ghost_published[sim->back] = (SimGhostView){
+            1, !g->game_over && !g->renascendo, g->player_x, g->world_head - g->player_y, g->score
+        };
+    }
+    int prev = __atomic_exchange_n(&sim->middle, sim->back | SIM_FRESH, __ATOMIC_ACQ_REL);
+    sim->back = prev & 3;
+}
+
+/* -------------------------------------------------------
+   UM TICK: ENTRADAS PENDENTES + game_update + PUBLICA
+ ------------------------------------------------------- */
+static void sim_record_latency(Sim *sim, const SimInput *in)
+{
+    double ms = (utils_now_seconds() - in->time) * 1000.0;
+    if (ms < 0.0) ms = 0.0;
+    sim->latency_ms[sim->latency_count % SIM_LATENCY_SAMPLES] = (float)ms;
+    sim->latency_count++;
+    sim->latency_ticks_sum += (double)(sim->tick - in->tick);
+}
+
+static void sim_drain_inputs(Sim *sim)
+{
+    unsigned tail = sim->input_tail;
+    unsigned head = __atomic_load_n(&sim->input_head, __ATOMIC_ACQUIRE);
+
+    while (tail != head) {
+        SimInput in = sim->inputs[tail & (SIM_INPUT_CAPACITY - 1)];
+        sim_record_latency(sim, &in);
+        if (sim->practice) rewind_record_input(&sim->rewind, sim->tick, in.player_id, in.key);
+        if (sim->recording) ghost_record(&sim->recorder, sim->tick, in.key);
+        if (in.player_id == 0) game_handle_input(&sim->live, in.key);
+        else                   game_handle_input_player(&sim->live, in.player_id, in.key);
+        tail++;
+    }
+    __atomic_store_n(&sim->input_tail, tail, __ATOMIC_RELEASE);
+}
+
+static void sim_tick(Sim *sim)
+{
+    sim->tick++;
+    sim_drain_inputs(sim);
+#ifdef ENABLE_PROFILER
+    double t0 = utils_now_seconds();
+#endif
+    TRACE_BEGIN("game_update");
+    if (!sim->live.game_over) game_update(&sim->live);
+    TRACE_END("game_update");
+#ifdef ENABLE_PROFILER
+    __atomic_add_fetch(&sim->update_ns, (long long)((utils_now_seconds() - t0) * 1e9), __ATOMIC_RELAXED);
+#endif
+    if (sim->ghost_active) {
+        // Mesma ordem do tick gravado: teclas do tick e depois game_update
+        TRACE_BEGIN("ghost_update");
+        char key;
+        while (ghost_player_next(&sim->ghost_player, sim->tick, &key)) game_handle_input(&sim->ghost, key);
+        if (!sim->ghost.game_over) game_update(&sim->ghost);
+        TRACE_END("ghost_update");
+    }
+    if (sim->practice) {
+        TRACE_BEGIN("rewind_checkpoint");
+        rewind_after_tick(&sim->rewind, &sim->live, sim->tick);
+        TRACE_END("rewind_checkpoint");
+    }
+}
+
+// Volta pedida pelo render: restaura e publica na hora (mesmo com a partida acabada)
+static void sim_apply_rewind(Sim *sim)
+{
+    unsigned ticks = __atomic_exchange_n(&sim->rewind_request, 0, __ATOMIC_ACQ_REL);
+    if (ticks == 0 || !sim->practice) return;
+
+    TRACE_BEGIN("rewind_restore");
+    unsigned tick = ticks < sim->tick ? sim->tick - ticks : 0;
+    int ok = rewind_to(&sim->rewind, &sim->live, &tick);
+    TRACE_END("rewind_restore");
+    if (!ok) return;
+
+    sim->tick = tick;
+    sim->next_tick = utils_now_seconds() + SIM_DT;
+    sim_publish(sim, utils_now_seconds());
+}
+
+/* -------------------------------------------------------
+   RELÓGIO
+   - Velocidade K: K ticks por período de 1/GAME_TICK_HZ.
+   - SIM_SPEED_UNBOUNDED: ticks seguidos por fatias de
+     SIM_TURBO_SLICE, até o processador aguentar.
+   - Só o último tick de cada lote é publicado: o render fica
+     naturalmente dizimado (vê 1 a cada K ticks, ou menos).
+ ------------------------------------------------------- */
+static void sim_run_due_ticks(Sim *sim)
+{
+    if (sim->practice) sim_apply_rewind(sim);
+
+    int speed = sim_get_speed(sim);
+    double now = utils_now_seconds();
+    int ran = 0;
+
+    if (speed == SIM_SPEED_UNBOUNDED) {
+        double slice_end = now + SIM_TURBO_SLICE;
+        while (!sim->live.game_over && utils_now_seconds() < slice_end) {
+            sim_tick(sim);
+            ran = 1;
+        }
+        sim->next_tick = utils_now_seconds();   // volta a 1x sem tentar "recuperar" ticks
+    } else {
+        double dt = SIM_DT / speed;
+        if (now - sim->next_tick > SIM_MAX_LAG) sim->next_tick = now;   // travou: não tenta recuperar tudo
+
+        while (now >= sim->next_tick) {
+            if (sim->practice && sim->live.game_over) {
+                // Prática: a partida acabada fica parada esperando uma volta no tempo
+                sim->next_tick = now + dt;
+                break;
+            }
+            sim_tick(sim);
+            sim->next_tick += dt;
+            ran = 1;
+        }
+    }
+    if (ran) sim_publish(sim, speed == 1 ? sim->next_tick - SIM_DT : now);
+}
+
+static void sim_thread_main(void *arg)
+{
+    Sim *sim = (Sim *)arg;
+    trace_thread_name("sim");
+
+    while (__atomic_load_n(&sim->running, __ATOMIC_ACQUIRE)) {
+        sim_run_due_ticks(sim);
+
+        // Dorme até perto do próximo prazo (granularidade de 1 ms)
+        // Turbo sem limite só dorme quando a partida acabou (não há o que simular)
+        if (sim_get_speed(sim) == SIM_SPEED_UNBOUNDED) {
+            if (sim->live.game_over) utils_sleep_ms(1);
+            continue;
+        }
+        double wait = sim->next_tick - utils_now_seconds();
+        if (wait > 0.001) utils_sleep_ms((int)(wait * 1000.0));
+    }
+    trace_thread_exit();
+}
+
+/* -------------------------------------------------------
+   API
+ ------------------------------------------------------- */
+// seed 0 = semente nova; ghost só vale com semente fixa
+static void sim_start_mode(Sim *sim, int two_players, int threaded, int rewind_seconds,
+                           unsigned int seed, const GhostRun *ghost)
+{
+    sim_stop(sim);
+
+    if (sim->started) game_destroy(&sim->live);
+    game_init_seeded(&sim->live, MAP_WIDTH, seed ? seed : game_make_seed());
+    game_set_two_players(&sim->live, two_players);
+    sim->started = 1;
+
+    // Fantasma: outro GameState com a mesma semente, alimentado pelas teclas gravadas
+    sim->recording = seed != 0;
+    ghost_recorder_reset(&sim->recorder);
+    if (sim->ghost_started) game_destroy(&sim->ghost);
+    sim->ghost_started = 0;
+    sim->ghost_active = 0;
+    memset(sim->ghost_published, 0, sizeof(sim->ghost_published));
+    if (ghost && seed && ghost->seed == seed) {
+        sim->ghost_run = *ghost;
+        game_init_seeded(&sim->ghost, MAP_WIDTH, seed);
+        ghost_player_start(&sim->ghost_player, &sim->ghost_run);
+        sim->ghost_started = 1;
+        sim->ghost_active = 1;
+    }
+
+    // Os três buffers começam com o estado inicial
+    double now = utils_now_seconds();
+    sim->tick = 0;
+    for (int i = 0; i < 3; ++i) {
+        game_copy_state(&sim->buffers[i], &sim->live);
+        sim->published_at[i] = now;
+        sim->published_tick[i] = 0;
+    }
+    sim->back = 0;
+    sim->middle = 1;
+    sim->front = 2;
+
+    sim->input_head = 0;
+    sim->input_tail = 0;
+    sim->next_tick = now + SIM_DT;
+    sim->latency_count = 0;
+    sim->latency_ticks_sum = 0.0;
+
+    sim->practice = rewind_seconds > 0 && rewind_init(&sim->rewind, rewind_seconds);
+    if (sim->practice) rewind_after_tick(&sim->rewind, &sim->live, 0);   // dá para voltar até o início
+    else rewind_free(&sim->rewind);
+    sim->rewind_request = 0;
+    memset(sim->rewind_published, 0, sizeof(sim->rewind_published));
+    if (sim->ghost_active) {
+        for (int i = 0; i < 3; ++i) {
+            sim->ghost_published[i] = (SimGhostView){ 1, 1, sim->ghost.player_x,
+                                                      sim->ghost.world_head - sim->ghost.player_y, 0 };
+        }
+    }
+
+    sim->threaded = threaded;
+    if (threaded) {
+        __atomic_store_n(&sim->running, 1, __ATOMIC_RELEASE);
+        if (!utils_thread_start(&sim->thread, sim_thread_main, sim)) {
+            // Sem thread: cai para o modo em que o render chama sim_pump
+            sim->running = 0;
+            sim->threaded = 0;
+        }
+    }
+}
+
+void sim_start(Sim *sim, int two_players, int threaded)
+{
+    if (!sim) return;
+    sim_start_mode(sim, two_players, threaded, 0, 0, NULL);
+}
+
+void sim_start_practice(Sim *sim, int two_players, int threaded, int rewind_seconds)
+{
+    if (!sim) return;
+    sim_start_mode(sim, two_players, threaded, rewind_seconds, 0, NULL);
+}
+
+void sim_start_challenge(Sim *sim, unsigned int seed, const GhostRun *ghost, int threaded)
+{
+    if (!sim) return;
+    sim_start_mode(sim, 0, threaded, 0, seed ? seed : 1u, ghost);
+}
+
+const GhostRecorder *sim_recording(const Sim *sim)
+{
+    return (sim && sim->recording) ? &sim->recorder : NULL;
+}
+
+const SimGhostView *sim_ghost_view(const Sim *sim)
+{
+    return sim ? &sim->ghost_published[sim->front] : NULL;
+}
+
+void sim_request_rewind(Sim *sim, double seconds)
+{
+    if (!sim || !sim->practice || seconds <= 0.0) return;
+    __atomic_add_fetch(&sim->rewind_request, (unsigned)(seconds * GAME_TICK_HZ + 0.5), __ATOMIC_ACQ_REL);
+}
+
+const RewindStats *sim_rewind_stats(const Sim *sim)
+{
+    return sim ? &sim->rewind_published[sim->front] : NULL;
+}
+
+void sim_stop(Sim *sim)
+{
+    if (!sim || !sim->threaded) return;
+    if (__atomic_exchange_n(&sim->running, 0, __ATOMIC_ACQ_REL)) {
+        utils_thread_join(&sim->thread);
+    }
+    sim->threaded = 0;
+}
+
+void sim_release(Sim *sim)
+{
+    if (!sim) return;
+    sim_stop(sim);
+    if (sim->started) game_destroy(&sim->live);
+    for (int i = 0; i < 3; ++i) game_destroy(&sim->buffers[i]);
+    rewind_free(&sim->rewind);
+    if (sim->ghost_started) game_destroy(&sim->ghost);
+    memset(sim, 0, sizeof(*sim));
+}
+
+int sim_push_input(Sim *sim, int player_id, char key, double time)
+{
+    if (!sim) return 0;
+    unsigned head = sim->input_head;
+    unsigned tail = __atomic_load_n(&sim->input_tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= SIM_INPUT_CAPACITY) return 0;
+
+    sim->inputs[head & (SIM_INPUT_CAPACITY - 1)] = (SimInput){ player_id, key, time, sim_latest_tick(sim) };
+    __atomic_store_n(&sim->input_head, head + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+void sim_pump(Sim *sim)
+{
+    if (!sim || !sim->started || sim->threaded) return;
+    sim_run_due_ticks(sim);
+}
+
+const GameState *sim_latest(Sim *sim, float *alpha)
+{
+    if (!sim) return NULL;
+
+    if (__atomic_load_n(&sim->middle, __ATOMIC_ACQUIRE) & SIM_FRESH) {
+        int prev = __atomic_exchange_n(&sim->middle, sim->front, __ATOMIC_ACQ_REL);
+        sim->front = prev & 3;
+    }
+
+    if (alpha) {
+        // Em turbo os snapshots já pulam vários ticks: interpolar só atrapalharia
+        float a = 0.0f;
+        if (sim_get_speed(sim) == 1)
+            a = (float)((utils_now_seconds() - sim->published_at[sim->front]) / SIM_DT);
+        if (a < 0.0f) a = 0.0f;
+        if (a > 1.0f) a = 1.0f;
+        *alpha = a;
+    }
+    return &sim->buffers[sim->front];
+}
+
+unsigned sim_latest_tick(const Sim *sim)
+{
+    return sim ? sim->published_tick[sim->front] : 0;
+}
+
+void sim_set_speed(Sim *sim, int speed)
+{
+    if (!sim) return;
+    if (speed < 1 && speed != SIM_SPEED_UNBOUNDED) speed = 1;
+    __atomic_store_n(&sim->speed, speed, __ATOMIC_RELAXED);
+}
+
+int sim_get_speed(const Sim *sim)
+{
+    // 0 é o valor de uma Sim zerada: velocidade normal
+    int speed = sim ? __atomic_load_n(&sim->speed, __ATOMIC_RELAXED) : 1;
+    return speed == 0 ? 1 : speed;
+}
+
+double sim_ticks_per_second(Sim *sim, SimRate *rate)
+{
+    if (!sim || !rate) return 0.0;
+    double now = utils_now_seconds();
+    unsigned tick = sim_latest_tick(sim);
+
+    // Reamostra no máximo 2x por segundo para o número não ficar pulando
+    if (rate->time == 0.0 || tick < rate->tick) {
+        rate->time = now;
+        rate->tick = tick;
+    } else if (now - rate->time >= 0.5) {
+        rate->value = (double)(tick - rate->tick) / (now - rate->time);
+        rate->time = now;
+        rate->tick = tick;
+    }
+    return rate->value;
+}
+
+static int compare_float(const void *a, const void *b)
+{
+    float fa = *(const float *)a, fb = *(const float *)b;
+    return (fa > fb) - (fa < fb);
+}
+
+void sim_latency_stats(const Sim *sim, SimLatencyStats *out)
+{
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!sim || sim->latency_count == 0) return;
+
+    // Ordena uma cópia das amostras guardadas (no máximo SIM_LATENCY_SAMPLES)
+    static float sorted[SIM_LATENCY_SAMPLES];
+    int n = sim->latency_count < SIM_LATENCY_SAMPLES ? sim->latency_count : SIM_LATENCY_SAMPLES;
+    memcpy(sorted, sim->latency_ms, (size_t)n * sizeof(float));
+    qsort(sorted, (size_t)n, sizeof(float), compare_float);
+
+    out->count = sim->latency_count;
+    out->p50_ms = sorted[(n - 1) * 50 / 100];
+    out->p99_ms = sorted[(n - 1) * 99 / 100];
+    out->max_ms = sorted[n - 1];
+    out->mean_ticks = sim->latency_ticks_sum / sim->latency_count;
+}
+
+#ifdef ENABLE_PROFILER
+double sim_take_update_ms(Sim *sim)
+{
+    if (!sim) return 0.0;
+    return (double)__atomic_exchange_n(&sim->update_ns, 0, __ATOMIC_RELAXED) / 1e6;
+}
+#endif
@@ -0,0 +1,188 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include "game.h"
+#include "utils.h"
+#include "rewind.h"
+#include "ghost.h"
+
+// Simulação separada do render.
+// A thread de simulação roda game_update em GAME_TICK_HZ fixos sobre um estado próprio
+// e publica snapshots imutáveis num triple buffer sem locks; o render sempre lê o mais recente.
+// A entrada chega por uma fila SPSC (um produtor, um consumidor) também sem locks.
+
+// 1 = simulação na própria thread; 0 = roda os ticks no loop do render (sim_pump)
+#ifndef SIM_THREADED
+#define SIM_THREADED 1
+#endif
+
+#define SIM_INPUT_CAPACITY 64   // potência de 2
+#define SIM_LATENCY_SAMPLES 4096 // últimas amostras de latência guardadas por partida
+#define SIM_SPEED_UNBOUNDED (-1) // turbo sem limite: simula o mais rápido possível
+
+typedef struct SimInput {
+    int player_id;   // 0 = modo 1 jogador, 1 = P1, 2 = P2
+    char key;        // 'W', 'A', 'S', 'D'
+    double time;     // utils_now_seconds() quando a tecla foi lida
+    unsigned tick;   // tick do snapshot que o jogador estava vendo
+} SimInput;
+
+// Latência entrada -> simulação da partida atual
+typedef struct SimLatencyStats {
+    int count;       // entradas aplicadas na partida
+    double p50_ms;
+    double p99_ms;
+    double max_ms;
+    double mean_ticks; // ticks entre o snapshot visto e o tick que aplicou a entrada
+} SimLatencyStats;
+
+// Onde desenhar o fantasma, publicado junto de cada snapshot
+typedef struct SimGhostView {
+    int active;         // 0 = partida sem fantasma
+    int alive;          // 0 = a partida gravada já acabou
+    int x;
+    int row_id;         // world_head - player_y: identifica a linha do mundo, não a da tela
+    int score;
+} SimGhostView;
+
+typedef struct Sim {
+    GameState live;                       // estado mutável, só a simulação mexe
+    GameState buffers[3];                 // snapshots publicados (triple buffer)
+    double published_at[3];               // instante (utils_now_seconds) do tick de cada snapshot
+    unsigned published_tick[3];           // número do tick de cada snapshot
+    unsigned tick;                        // ticks simulados na partida
+    int back;                             // buffer sendo escrito pela simulação
+    int front;                            // buffer sendo lido pelo render
+    int middle;                           // atômico: último publicado | SIM_FRESH
+
+    SimInput inputs[SIM_INPUT_CAPACITY];  // fila SPSC de entrada
+    unsigned input_head;                  // atômico: escrito pelo produtor (render)
+    unsigned input_tail;                  // atômico: escrito pelo consumidor (simulação)
+
+    int running;                          // atômico: 0 pede para a thread terminar
+    int threaded;
+    int started;
+    UtilsThread thread;
+    double next_tick;                     // prazo do próximo tick
+    int speed;                            // atômico: ticks por período (0/1 = normal) ou SIM_SPEED_UNBOUNDED
+
+    // Modo prática: histórico para voltar no tempo (só a simulação mexe no buffer)
+    int practice;
+    RewindBuffer rewind;
+    unsigned rewind_request;              // atômico: ticks a voltar pedidos pelo render (0 = nada)
+    RewindStats rewind_published[3];      // estatísticas junto de cada snapshot
+
+    // Desafio com fantasma: grava as teclas da partida e re-simula a gravada ao lado
+    int recording;
+    GhostRecorder recorder;
+    int ghost_active;
+    int ghost_started;                    // ghost tem filas alocadas
+    GhostRun ghost_run;
+    GhostPlayer ghost_player;
+    GameState ghost;
+    SimGhostView ghost_published[3];
+
+    // Instrumentação de latência (escrita só pela simulação; ler após sim_stop)
+    float latency_ms[SIM_LATENCY_SAMPLES];
+    int latency_count;
+    double latency_ticks_sum;
+
+#ifdef ENABLE_PROFILER
+    long long update_ns;                  // atômico: tempo em game_update ainda não coletado
+#endif
+} Sim;
+
+// Medidor de ticks/s a partir dos snapshots publicados (guardado por quem mede)
+typedef struct SimRate {
+    double time;
+    unsigned tick;
+    double value;
+} SimRate;
+
+/**
+ * Começa uma partida nova e (se threaded) sobe a thread de simulação
+ * Pode ser chamada de novo após sim_stop; libera o estado da partida anterior
+ * @param two_players 1 = modo 2 jogadores
+ * @param threaded 1 = thread própria, 0 = ticks rodam em sim_pump
+ */
+void sim_start(Sim *sim, int two_players, int threaded);
+
+/**
+ * Como sim_start, mas em modo prática: grava checkpoints para sim_request_rewind
+ * @param rewind_seconds Quanto histórico manter
+ */
+void sim_start_practice(Sim *sim, int two_players, int threaded, int rewind_seconds);
+
+/**
+ * Desafio: partida de 1 jogador com semente fixa, gravando as teclas (sim_recording)
+ * @param ghost Partida a re-simular ao lado como fantasma (copiada; NULL = sem fantasma)
+ */
+void sim_start_challenge(Sim *sim, unsigned int seed, const GhostRun *ghost, int threaded);
+
+// Teclas gravadas na partida do desafio (ler após sim_stop); NULL se não estava gravando
+const GhostRecorder *sim_recording(const Sim *sim);
+
+// Fantasma que acompanha o snapshot mais recente
+const SimGhostView *sim_ghost_view(const Sim *sim);
+
+/**
+ * Pede para voltar seconds segundos (aplicado no começo do próximo tick da simulação)
+ * Funciona também com a partida acabada: a simulação volta a andar do ponto restaurado.
+ */
+void sim_request_rewind(Sim *sim, double seconds);
+
+// Estatísticas do histórico que acompanham o snapshot mais recente (zeradas fora da prática)
+const RewindStats *sim_rewind_stats(const Sim *sim);
+
+// Para a thread de simulação. O último snapshot continua válido até o próximo sim_start.
+void sim_stop(Sim *sim);
+
+// Libera toda a memória da simulação (chamar uma vez no fim)
+void sim_release(Sim *sim);
+
+/**
+ * Enfileira um movimento com o instante em que foi lido
+ * Todas as entradas enfileiradas são aplicadas, em ordem, no começo do próximo tick
+ * @param time utils_now_seconds() da leitura da tecla
+ * @return 0 se a fila estiver cheia (entrada descartada)
+ */
+int sim_push_input(Sim *sim, int player_id, char key, double time);
+
+// Número do tick do snapshot que o render está mostrando
+unsigned sim_latest_tick(const Sim *sim);
+
+/**
+ * Percentis da latência entrada -> simulação da partida atual
+ * Chamar com a simulação parada (sim_stop) ou no mesmo thread dela
+ */
+void sim_latency_stats(const Sim *sim, SimLatencyStats *out);
+
+#ifdef ENABLE_PROFILER
+// Tempo gasto em game_update desde a última chamada (zera o acumulador)
+double sim_take_update_ms(Sim *sim);
+#endif
+
+/**
+ * Turbo: roda speed ticks a cada período de 1/GAME_TICK_HZ (1 = normal)
+ * Com SIM_SPEED_UNBOUNDED simula o mais rápido possível. Só o último tick de cada
+ * lote é publicado, então o render mostra 1 a cada K ticks. Vale na hora, sem reiniciar.
+ */
+void sim_set_speed(Sim *sim, int speed);
+int sim_get_speed(const Sim *sim);
+
+/**
+ * Ticks por segundo realmente simulados (medidos pelos snapshots)
+ * @param rate Estado do medidor, zerado na primeira chamada
+ */
+double sim_ticks_per_second(Sim *sim, SimRate *rate);
+
+// Modo sem thread: roda os ticks vencidos. Com thread não faz nada.
+void sim_pump(Sim *sim);
+
+/**
+ * Snapshot mais recente publicado pela simulação
+ * @param alpha Se não for NULL, recebe a fração (0..1) do próximo tick já decorrida
+ */
+const GameState *sim_latest(Sim *sim, float *alpha);
+
+#endif // SIM_H
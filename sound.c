@@ -11,7 +11,6 @@ void sound_init(void) {
     InitAudioDevice();
 
     // Aguarda um pequeno tempo para inicializar corretamente o driver de áudio
-    SetExitKey(0);
     WaitTime(0.2);
 
     // Caminho certo
@@ -0,0 +1,327 @@
+#include "term_view.h"
+#include "game.h"
+#include "utils.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifndef RANKING_FILE
+#define RANKING_FILE "ranking.txt"
+#endif
+
+/* -------------------------------------------------------
+   LAYOUT
+   - 2 linhas de HUD, borda, MAP_HEIGHT linhas de mapa, borda.
+ ------------------------------------------------------- */
+#define TERM_HUD_ROWS 2
+#define TERM_COLS (MAP_WIDTH + 2)
+#define TERM_ROWS (TERM_HUD_ROWS + MAP_HEIGHT + 2)
+#define TERM_MAP_TOP (TERM_HUD_ROWS + 1)
+// Pior caso por célula: posicionar cursor + trocar cor + caractere
+#define TERM_OUT_CAP (TERM_ROWS * TERM_COLS * 24 + 64)
+
+// Cores ANSI (0..7); cada célula guarda fg | (bg << 4)
+enum { C_BLACK = 0, C_RED, C_GREEN, C_YELLOW, C_BLUE, C_MAGENTA, C_CYAN, C_WHITE };
+#define TERM_COLOR(fg, bg) ((unsigned char)((fg) | ((bg) << 4)))
+#define TERM_DEFAULT TERM_COLOR(C_WHITE, C_BLACK)
+
+typedef struct TermCell {
+    char ch;
+    unsigned char color;
+} TermCell;
+
+static TermCell prev_frame[TERM_ROWS][TERM_COLS];  // o que o terminal está mostrando
+static TermCell next_frame[TERM_ROWS][TERM_COLS];  // frame sendo montado
+static int prev_valid = 0;
+
+// Estado do terminal após o último write (cursor e cor atuais)
+static int term_row = -1, term_col = -1;
+static int term_color = -1;
+
+static char out_buf[TERM_OUT_CAP];
+static int out_len = 0;
+
+static int last_frame_bytes = 0;
+static long long total_bytes = 0;
+static int total_frames = 0;
+
+void term_view_reset(void)
+{
+    prev_valid = 0;
+    term_row = term_col = -1;
+    term_color = -1;
+    last_frame_bytes = 0;
+    total_bytes = 0;
+    total_frames = 0;
+}
+
+int term_view_last_frame_bytes(void)
+{
+    return last_frame_bytes;
+}
+
+void term_view_stats(long long *bytes, int *frames)
+{
+    if (bytes) *bytes = total_bytes;
+    if (frames) *frames = total_frames;
+}
+
+/* -------------------------------------------------------
+   MONTAGEM DO FRAME
+ ------------------------------------------------------- */
+static void put_cell(int r, int c, char ch, unsigned char color)
+{
+    if (r < 0 || r >= TERM_ROWS || c < 0 || c >= TERM_COLS) return;
+    next_frame[r][c].ch = ch;
+    next_frame[r][c].color = color;
+}
+
+static void put_text(int r, int c, const char *text, unsigned char color)
+{
+    for (; *text && c < TERM_COLS; ++text, ++c) put_cell(r, c, *text, color);
+}
+
+static unsigned char row_background(RowType type)
+{
+    switch (type) {
+        case ROW_GRASS: return C_GREEN;
+        case ROW_RIVER: return C_BLUE;
+        default:        return C_BLACK;
+    }
+}
+
+static void compose_frame(const GameState *state)
+{
+    for (int r = 0; r < TERM_ROWS; ++r) {
+        for (int c = 0; c < TERM_COLS; ++c) {
+            next_frame[r][c].ch = ' ';
+            next_frame[r][c].color = TERM_DEFAULT;
+        }
+    }
+
+    // HUD
+    char hud[64];
+    if (state->two_players) {
+        snprintf(hud, sizeof(hud), "P1: %d  P2: %d", state->p1.score, state->p2.score);
+    } else {
+        snprintf(hud, sizeof(hud), "Score: %d  Vidas: %d", state->score, state->vidas);
+    }
+    put_text(0, 0, hud, TERM_COLOR(C_YELLOW, C_BLACK));
+    snprintf(hud, sizeof(hud), "%d bytes/frame", last_frame_bytes);
+    put_text(1, 0, hud, TERM_COLOR(C_CYAN, C_BLACK));
+
+    // Bordas
+    for (int c = 0; c < TERM_COLS; ++c) {
+        char ch = (c == 0 || c == TERM_COLS - 1) ? '+' : '-';
+        put_cell(TERM_MAP_TOP - 1, c, ch, TERM_DEFAULT);
+        put_cell(TERM_MAP_TOP + MAP_HEIGHT, c, ch, TERM_DEFAULT);
+    }
+
+    // Mapa
+    for (int y = 0; y < MAP_HEIGHT; ++y) {
+        const Row *row = &state->rows[y];
+        int r = TERM_MAP_TOP + y;
+        unsigned char bg = row_background(row->type);
+
+        put_cell(r, 0, '|', TERM_DEFAULT);
+        put_cell(r, TERM_COLS - 1, '|', TERM_DEFAULT);
+
+        for (int x = 0; x < MAP_WIDTH; ++x) {
+            char cell = row->queue ? queue_get_cell(row->queue, x) : ' ';
+            char ch = ' ';
+            unsigned char fg = C_WHITE;
+
+            if (cell == CHAR_CAR)       { ch = CHAR_CAR;  fg = C_RED; }
+            else if (cell == CHAR_LOG)  { ch = '#';       fg = C_YELLOW; }
+            else if (cell == CHAR_LIFE) { ch = CHAR_LIFE; fg = C_RED; }
+            else if (row->type == ROW_ROAD && (x % 2) == 0) { ch = CHAR_ROAD; fg = C_WHITE; }
+
+            put_cell(r, x + 1, ch, TERM_COLOR(fg, bg));
+        }
+    }
+
+    // Jogadores (por cima do mapa)
+    if (state->two_players) {
+        if (state->p1.alive && state->p1.y >= 0 && state->p1.y < MAP_HEIGHT) {
+            put_cell(TERM_MAP_TOP + state->p1.y, state->p1.x + 1, '1',
+                     TERM_COLOR(C_YELLOW, row_background(state->rows[state->p1.y].type)));
+        }
+        if (state->p2.alive && state->p2.y >= 0 && state->p2.y < MAP_HEIGHT) {
+            put_cell(TERM_MAP_TOP + state->p2.y, state->p2.x + 1, '2',
+                     TERM_COLOR(C_CYAN, row_background(state->rows[state->p2.y].type)));
+        }
+    } else if (state->player_y >= 0 && state->player_y < MAP_HEIGHT) {
+        put_cell(TERM_MAP_TOP + state->player_y, state->player_x + 1, CHAR_PLAYER,
+                 TERM_COLOR(C_MAGENTA, row_background(state->rows[state->player_y].type)));
+    }
+
+    if (state->renascendo) {
+        snprintf(hud, sizeof(hud), " Reaparecendo em %d... ", (int)(state->renascer_timer + 0.999f));
+        put_text(TERM_MAP_TOP + MAP_HEIGHT / 2, 2, hud, TERM_COLOR(C_YELLOW, C_RED));
+    }
+}
+
+/* -------------------------------------------------------
+   DIFF + EMISSÃO
+   - Só células diferentes do frame anterior.
+   - Pulo curto na mesma linha com a mesma cor: reescreve as
+     células em vez de mandar um CUP (mais barato em bytes).
+ ------------------------------------------------------- */
+static void out_append(const char *s, int n)
+{
+    if (out_len + n > TERM_OUT_CAP) return;
+    memcpy(out_buf + out_len, s, (size_t)n);
+    out_len += n;
+}
+
+static void out_move(int r, int c)
+{
+    char seq[16];
+    int n = snprintf(seq, sizeof(seq), "\033[%d;%dH", r + 1, c + 1);
+    out_append(seq, n);
+    term_row = r;
+    term_col = c;
+}
+
+static void out_color(unsigned char color)
+{
+    if (term_color == color) return;
+    char seq[16];
+    int n = snprintf(seq, sizeof(seq), "\033[3%d;4%dm", color & 7, (color >> 4) & 7);
+    out_append(seq, n);
+    term_color = color;
+}
+
+static void out_cell(int r, int c, const TermCell *cell)
+{
+    out_color(cell->color);
+    out_append(&cell->ch, 1);
+    term_row = r;
+    term_col = c + 1;
+    if (term_col >= TERM_COLS) term_row = term_col = -1;   // quebra de linha pendente: posição incerta
+}
+
+#define TERM_MAX_SKIP 4
+
+void game_render(const GameState *state)
+{
+    if (!state) return;
+    compose_frame(state);
+    out_len = 0;
+
+    if (!prev_valid) {
+        out_append("\033[0m\033[2J", 8);
+        term_color = -1;
+        term_row = term_col = -1;
+    }
+
+    for (int r = 0; r < TERM_ROWS; ++r) {
+        for (int c = 0; c < TERM_COLS; ++c) {
+            const TermCell *cell = &next_frame[r][c];
+            if (prev_valid && prev_frame[r][c].ch == cell->ch && prev_frame[r][c].color == cell->color) {
+                continue;
+            }
+
+            int gap = (term_row == r) ? c - term_col : -1;
+            int can_fill = (gap > 0 && gap <= TERM_MAX_SKIP);
+            for (int k = term_col; can_fill && k < c; ++k) {
+                if (next_frame[r][k].color != term_color) can_fill = 0;
+            }
+
+            if (can_fill) {
+                for (int k = term_col; k < c; ++k) out_cell(r, k, &next_frame[r][k]);
+            } else if (gap != 0) {
+                out_move(r, c);
+            }
+            out_cell(r, c, cell);
+        }
+    }
+
+    last_frame_bytes = (out_len > 0) ? utils_write_stdout(out_buf, out_len) : 0;
+    total_bytes += last_frame_bytes;
+    total_frames++;
+
+    memcpy(prev_frame, next_frame, sizeof(prev_frame));
+    prev_valid = 1;
+}
+
+void term_view_status(const char *text)
+{
+    char line[160];
+    int n = snprintf(line, sizeof(line), "\033[0m\033[%d;1H\033[K%s", TERM_ROWS + 1, text ? text : "");
+    if (n >= (int)sizeof(line)) n = (int)sizeof(line) - 1;
+    utils_write_stdout(line, n);
+    term_color = -1;            // cor e cursor mudaram por fora do diff
+    term_row = term_col = -1;
+}
+
+/* -------------------------------------------------------
+   LOOP DO JOGO NO TERMINAL
+ ------------------------------------------------------- */
+void term_run_game(Ranking *ranking)
+{
+    char name[MAX_NAME_LEN + 1] = {0};
+    printf("Digite seu nome: ");
+    fflush(stdout);
+    if (!fgets(name, sizeof(name), stdin)) name[0] = '\0';
+    name[strcspn(name, "\r\n")] = '\0';
+    if (name[0] == '\0') strcpy(name, "Player");
+
+    GameState state;
+    memset(&state, 0, sizeof(state));
+    game_init(&state, MAP_WIDTH);
+
+    utils_enable_raw_mode();
+    utils_write_stdout("\033[?25l", 6);   // esconde o cursor
+    term_view_reset();
+
+    const double dt = 1.0 / GAME_TICK_HZ;
+    double next_tick = utils_now_seconds();
+    UtilsKeyEvent events[32];
+
+    while (!state.game_over) {
+        // Dorme até chegar tecla ou vencer o prazo do próximo tick
+        int timeout_ms = (int)((next_tick - utils_now_seconds()) * 1000.0);
+        if (timeout_ms < 0) timeout_ms = 0;
+
+        int n = utils_read_keys(events, 32, timeout_ms);
+        for (int i = 0; i < n; ++i) {
+            game_handle_input(&state, events[i].key);
+        }
+
+        double now = utils_now_seconds();
+        if (now < next_tick) continue;
+        if (now - next_tick > 0.25) next_tick = now;   // travou: não tenta recuperar tudo
+        next_tick += dt;
+
+        game_update(&state);
+        game_render(&state);
+    }
+    game_render(&state);
+
+    // Restaura cor/cursor e posiciona abaixo do mapa
+    char tail[32];
+    int n = snprintf(tail, sizeof(tail), "\033[0m\033[?25h\033[%d;1H\n", TERM_ROWS + 1);
+    utils_write_stdout(tail, n);
+    utils_disable_raw_mode();
+
+    long long bytes;
+    int frames;
+    term_view_stats(&bytes, &frames);
+    printf("Fim de jogo! Pontuacao: %d\n", state.score);
+    printf("Terminal: %d frames, %lld bytes (%.1f bytes/frame em media)\n",
+           frames, bytes, frames > 0 ? (double)bytes / frames : 0.0);
+
+    ranking_add(ranking, RANKING_MODE_SOLO, 0, name, state.score, RANKING_FILE);
+    printf("Colocacao: #%u de %u partidas (top %.1f%%)\n", (unsigned)ranking_place_of(ranking, RANKING_MODE_SOLO, state.score),
+           (unsigned)ranking_total_runs(ranking, RANKING_MODE_SOLO), ranking_top_percent(ranking, RANKING_MODE_SOLO, state.score));
+    PlayerStats stats;
+    if (ranking_player_stats(name, &stats)) {
+        printf("%s: recorde %d, %u partidas, media %.0f\n", name, stats.best, (unsigned)stats.runs, stats.mean);
+    }
+    game_destroy(&state);
+
+    printf("ENTER para voltar ao menu...");
+    fflush(stdout);
+    char buffer[8];
+    if (!fgets(buffer, sizeof(buffer), stdin)) return;
+}
@@ -0,0 +1,27 @@
+#ifndef TERM_VIEW_H
+#define TERM_VIEW_H
+
+#include "game.h"
+#include "ranking.h"
+
+// Frontend de terminal.
+// game_render (declarada em game.h) guarda o último frame emitido e escreve só as células
+// que mudaram, com sequências ANSI endereçadas por cursor, num único write() por frame.
+// Pensado para rodar por links lentos (serial/SSH) com poucos bytes por frame.
+
+// Esquece o frame anterior: o próximo game_render redesenha a tela inteira
+void term_view_reset(void);
+
+// Bytes emitidos pelo último game_render (0 se nada mudou)
+int term_view_last_frame_bytes(void);
+
+// Totais desde o último term_view_reset
+void term_view_stats(long long *total_bytes, int *frames);
+
+// Escreve uma linha de status logo abaixo do último frame (não entra no diff)
+void term_view_status(const char *text);
+
+// Loop do jogo no terminal (modo 1 jogador, WASD, Q para sair)
+void term_run_game(Ranking *ranking);
+
+#endif // TERM_VIEW_H
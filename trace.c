@@ -0,0 +1,167 @@
+#include "trace.h"
+#include "utils.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TRACE_MAX_THREADS 8
+#define TRACE_RING_SIZE 16384       // eventos por thread (potência de 2)
+#define TRACE_FLUSH_MS 20           // intervalo da thread de escrita
+
+typedef struct TraceEvent {
+    const char *name;
+    double ts;                      // segundos (utils_now_seconds)
+    char phase;                     // 'B', 'E' ou 'M' (metadado: nome da thread)
+} TraceEvent;
+
+// Ring SPSC: produtor = a thread dona, consumidor = thread de escrita
+typedef struct TraceRing {
+    TraceEvent events[TRACE_RING_SIZE];
+    unsigned head;                  // atômico: escrito pela thread dona
+    unsigned tail;                  // atômico: escrito pela thread de escrita
+    unsigned dropped;               // eventos perdidos com o ring cheio
+    int in_use;                     // atômico: 1 enquanto alguma thread é dona do ring
+} TraceRing;
+
+int trace_active = 0;
+
+static TraceRing rings[TRACE_MAX_THREADS];
+static __thread TraceRing *my_ring = NULL;
+
+static FILE *trace_file = NULL;
+static int first_event = 1;
+static double trace_origin = 0.0;
+static int writer_running = 0;      // atômico
+static UtilsThread writer;
+
+/* -------------------------------------------------------
+   PRODUTORES
+ ------------------------------------------------------- */
+static TraceRing *trace_my_ring(void)
+{
+    if (my_ring) return my_ring;
+    for (int i = 0; i < TRACE_MAX_THREADS; ++i) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&rings[i].in_use, &expected, 1, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            my_ring = &rings[i];
+            return my_ring;
+        }
+    }
+    return NULL;                    // threads demais ao mesmo tempo: esta fica sem trace
+}
+
+static void trace_push(const char *name, char phase)
+{
+    TraceRing *ring = trace_my_ring();
+    if (!ring) return;
+
+    unsigned head = ring->head;
+    unsigned tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= TRACE_RING_SIZE) {
+        ring->dropped++;
+        return;
+    }
+    ring->events[head & (TRACE_RING_SIZE - 1)] = (TraceEvent){ name, utils_now_seconds(), phase };
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+void trace_event(const char *name, char phase)
+{
+    trace_push(name, phase);
+}
+
+void trace_thread_name(const char *name)
+{
+    if (trace_active) trace_push(name, 'M');
+}
+
+void trace_thread_exit(void)
+{
+    // Os eventos já gravados continuam no ring até a thread de escrita drenar;
+    // a próxima thread que pegar o ring só continua a partir de head.
+    if (!my_ring) return;
+    __atomic_store_n(&my_ring->in_use, 0, __ATOMIC_RELEASE);
+    my_ring = NULL;
+}
+
+/* -------------------------------------------------------
+   THREAD DE ESCRITA
+ ------------------------------------------------------- */
+static void trace_write_event(int tid, const TraceEvent *ev)
+{
+    fputs(first_event ? "\n" : ",\n", trace_file);
+    first_event = 0;
+    if (ev->phase == 'M') {
+        fprintf(trace_file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                tid, ev->name);
+    } else {
+        fprintf(trace_file, "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                ev->name, ev->phase, (ev->ts - trace_origin) * 1e6, tid);
+    }
+}
+
+static void trace_drain(void)
+{
+    for (int i = 0; i < TRACE_MAX_THREADS; ++i) {
+        TraceRing *ring = &rings[i];
+        unsigned tail = ring->tail;
+        unsigned head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        while (tail != head) {
+            trace_write_event(i + 1, &ring->events[tail & (TRACE_RING_SIZE - 1)]);
+            tail++;
+        }
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+    }
+}
+
+static void trace_writer_main(void *arg)
+{
+    (void)arg;
+    while (__atomic_load_n(&writer_running, __ATOMIC_ACQUIRE)) {
+        trace_drain();
+        utils_sleep_ms(TRACE_FLUSH_MS);
+    }
+}
+
+/* -------------------------------------------------------
+   API
+ ------------------------------------------------------- */
+int trace_start(const char *path)
+{
+    if (!path || !path[0] || trace_file) return 0;
+
+    trace_file = fopen(path, "w");
+    if (!trace_file) return 0;
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", trace_file);
+    first_event = 1;
+    trace_origin = utils_now_seconds();
+
+    __atomic_store_n(&writer_running, 1, __ATOMIC_RELEASE);
+    if (!utils_thread_start(&writer, trace_writer_main, NULL)) {
+        fclose(trace_file);
+        trace_file = NULL;
+        writer_running = 0;
+        return 0;
+    }
+    __atomic_store_n(&trace_active, 1, __ATOMIC_RELEASE);
+    trace_thread_name("main");
+    return 1;
+}
+
+void trace_stop(void)
+{
+    if (!trace_file) return;
+
+    __atomic_store_n(&trace_active, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&writer_running, 0, __ATOMIC_RELEASE);
+    utils_thread_join(&writer);
+    trace_drain();
+
+    unsigned dropped = 0;
+    for (int i = 0; i < TRACE_MAX_THREADS; ++i) dropped += rings[i].dropped;
+
+    fputs("\n]}\n", trace_file);
+    fclose(trace_file);
+    trace_file = NULL;
+    if (dropped > 0) fprintf(stderr, "trace: %u eventos descartados (ring cheio)\n", dropped);
+}
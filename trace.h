@@ -0,0 +1,30 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// Exportação de zonas para um arquivo JSON no formato Chrome trace-event
+// (abre em chrome://tracing ou ui.perfetto.dev).
+// Ligado em tempo de execução: CROSSY_TRACE=arquivo.json ./crossy
+// Cada thread grava eventos no próprio ring buffer sem locks; uma thread de fundo
+// drena os rings e escreve o arquivo. Desligado, cada zona custa só um teste de flag.
+
+extern int trace_active;
+
+// Começa a gravar em path (NULL ou "" não faz nada). Retorna 1 se o trace foi ligado.
+int trace_start(const char *path);
+
+// Para a thread de escrita, drena os eventos pendentes e fecha o JSON
+void trace_stop(void);
+
+// Nomeia a thread atual no trace (aparece na linha do tempo)
+void trace_thread_name(const char *name);
+
+// Devolve o ring da thread atual para ser reaproveitado (chamar antes da thread terminar)
+void trace_thread_exit(void);
+
+// name deve ser uma string estática (só o ponteiro é guardado)
+void trace_event(const char *name, char phase);
+
+#define TRACE_BEGIN(name) do { if (trace_active) trace_event((name), 'B'); } while (0)
+#define TRACE_END(name)   do { if (trace_active) trace_event((name), 'E'); } while (0)
+
+#endif // TRACE_H
@@ -1,3 +1,7 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L  // clock_gettime/nanosleep com -std=c99
+#endif
+
 #include "utils.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -6,24 +10,35 @@
 
 #ifdef _WIN32
 #include <conio.h>
+#include <io.h>
 #include <windows.h>
+#define PSAPI_VERSION 2         // GetProcessMemoryInfo vem do kernel32 (sem -lpsapi)
+#include <psapi.h>
 #else
 #include <unistd.h>
 #include <termios.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #endif
 
 static int utils_seeded = 0;
 
 #ifndef _WIN32
 static struct termios orig_termios;
+static int orig_fl = -1;
 #endif
 
 void utils_sleep_ms(int ms) {
 #ifdef _WIN32
     Sleep((DWORD)ms);
 #else
-    usleep((useconds_t)(ms * 1000));
+    struct timespec ts;
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long)(ms % 1000) * 1000000L;
+    nanosleep(&ts, NULL);
 #endif
 }
 
@@ -46,40 +61,172 @@ void utils_enable_raw_mode(void) {
     raw.c_cc[VMIN] = 0;
     raw.c_cc[VTIME] = 0;
     tcsetattr(0, TCSANOW, &raw);
-    int flags = fcntl(0, F_GETFL, 0);
-    fcntl(0, F_SETFL, flags | O_NONBLOCK);
+    orig_fl = fcntl(0, F_GETFL, 0);
+    fcntl(0, F_SETFL, orig_fl | O_NONBLOCK);
 #endif
 }
 
 void utils_disable_raw_mode(void) {
 #ifndef _WIN32
     tcsetattr(0, TCSANOW, &orig_termios);
+    // Sem isso o fgets do menu volta EOF na hora (stdin ficaria não bloqueante)
+    if (orig_fl != -1) fcntl(0, F_SETFL, orig_fl);
 #endif
 }
 
-int utils_read_key_nonblock(void) {
+/* -------------------------------------------------------
+   ENTRADA BUFERIZADA
+   - Um read() drena tudo que está pendente no terminal.
+   - Sequências CSI/SS3 de setas viram W/A/S/D.
+   - Eventos carregam o instante (monotônico) da leitura.
+ ------------------------------------------------------- */
+#define UTILS_INPUT_BYTES 256
+#define UTILS_PENDING_EVENTS 64
+
+static UtilsKeyEvent pending_events[UTILS_PENDING_EVENTS];  // usado por utils_read_key_nonblock
+static int pending_head = 0, pending_count = 0;
+
 #ifdef _WIN32
-    if (_kbhit()) {
-        int ch = _getch();
-        if (ch == 0 || ch == 224) {
-            // Arrow keys prefix, read and map to WASD equivalents if desired
-            int ext = _getch();
-            switch (ext) {
-                case 72: return 'W'; // up
-                case 80: return 'S'; // down
-                case 75: return 'A'; // left
-                case 77: return 'D'; // right
-                default: return -1;
-            }
+// Decodifica uma tecla do console (prefixo 0/224 = tecla estendida)
+static int utils_console_key(void) {
+    int ch = _getch();
+    if (ch == 0 || ch == 224) {
+        // Arrow keys prefix, read and map to WASD equivalents
+        int ext = _getch();
+        switch (ext) {
+            case 72: return 'W'; // up
+            case 80: return 'S'; // down
+            case 75: return 'A'; // left
+            case 77: return 'D'; // right
+            default: return -1;
         }
-        return toupper(ch);
     }
-    return -1;
+    return toupper(ch);
+}
 #else
-    unsigned char ch;
-    int n = (int)read(0, &ch, 1);
-    if (n == 1) return toupper(ch);
-    return -1;
+static unsigned char input_bytes[UTILS_INPUT_BYTES];
+static int input_len = 0;
+
+static int utils_arrow_to_wasd(unsigned char final) {
+    switch (final) {
+        case 'A': return 'W'; // up
+        case 'B': return 'S'; // down
+        case 'C': return 'D'; // right
+        case 'D': return 'A'; // left
+        default:  return -1;
+    }
+}
+
+// Decodifica input_bytes em eventos. Retorna quantos bytes consumiu;
+// uma sequência de escape incompleta no fim fica no buffer para a próxima leitura.
+static int utils_decode_keys(UtilsKeyEvent *out, int max_events, int *count, double t) {
+    int i = 0;
+    while (i < input_len && *count < max_events) {
+        unsigned char ch = input_bytes[i];
+        if (ch != 27) {
+            out[(*count)++] = (UtilsKeyEvent){ toupper(ch), t };
+            i++;
+            continue;
+        }
+        if (i + 1 >= input_len) break;                       // ESC sozinho: pode ser o começo de uma seta
+
+        unsigned char kind = input_bytes[i + 1];
+        if (kind != '[' && kind != 'O') {                    // ESC + tecla comum (Alt+tecla): entrega o ESC
+            out[(*count)++] = (UtilsKeyEvent){ 27, t };
+            i++;
+            continue;
+        }
+
+        // CSI: ESC [ parâmetros... byte final (0x40..0x7E); SS3: ESC O final
+        int j = i + 2;
+        while (j < input_len && kind == '[' && (input_bytes[j] < 0x40 || input_bytes[j] > 0x7E)) j++;
+        if (j >= input_len) break;                           // sequência ainda incompleta
+
+        int key = utils_arrow_to_wasd(input_bytes[j]);
+        if (key != -1) out[(*count)++] = (UtilsKeyEvent){ key, t };
+        i = j + 1;                                           // outras sequências são ignoradas
+    }
+    return i;
+}
+#endif
+
+int utils_read_keys(UtilsKeyEvent *out, int max_events, int timeout_ms) {
+    if (!out || max_events <= 0) return 0;
+    int count = 0;
+#ifdef _WIN32
+    if (!_kbhit() && timeout_ms != 0) {
+        WaitForSingleObject(GetStdHandle(STD_INPUT_HANDLE), timeout_ms < 0 ? INFINITE : (DWORD)timeout_ms);
+    }
+    double t = utils_now_seconds();
+    while (count < max_events && _kbhit()) {
+        int key = utils_console_key();
+        if (key != -1) out[count++] = (UtilsKeyEvent){ key, t };
+    }
+    return count;
+#else
+    // Se já há um escape pela metade, espera só um pouco pelo resto dele
+    int had_partial = (input_len > 0);
+    if (had_partial && (timeout_ms < 0 || timeout_ms > 20)) timeout_ms = 20;
+
+    struct pollfd pfd = { 0, POLLIN, 0 };
+    int ready = poll(&pfd, 1, timeout_ms);
+
+    int got = 0;
+    if (ready > 0 && input_len < UTILS_INPUT_BYTES) {
+        ssize_t n = read(0, input_bytes + input_len, (size_t)(UTILS_INPUT_BYTES - input_len));
+        if (n > 0) {
+            input_len += (int)n;
+            got = 1;
+        }
+    }
+
+    double t = utils_now_seconds();
+    int used = utils_decode_keys(out, max_events, &count, t);
+    memmove(input_bytes, input_bytes + used, (size_t)(input_len - used));
+    input_len -= used;
+
+    // Nada novo chegou e o escape continua incompleto: era um ESC de verdade
+    if (!got && had_partial && input_len > 0 && count < max_events) {
+        out[count++] = (UtilsKeyEvent){ 27, t };
+        input_len = 0;
+    }
+    return count;
+#endif
+}
+
+int utils_read_key_nonblock(void) {
+    if (pending_count == 0) {
+        pending_head = 0;
+        pending_count = utils_read_keys(pending_events, UTILS_PENDING_EVENTS, 0);
+        if (pending_count == 0) return -1;
+    }
+    int key = pending_events[pending_head].key;
+    pending_head++;
+    pending_count--;
+    return key;
+}
+
+int utils_write_stdout(const char *buf, int len) {
+    if (!buf || len <= 0) return 0;
+#ifdef _WIN32
+    DWORD written = 0;
+    fflush(stdout);
+    if (!WriteFile(GetStdHandle(STD_OUTPUT_HANDLE), buf, (DWORD)len, &written, NULL)) return 0;
+    return (int)written;
+#else
+    int total = 0;
+    while (total < len) {
+        ssize_t n = write(1, buf + total, (size_t)(len - total));
+        if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+            // stdout costuma compartilhar o O_NONBLOCK do raw mode: espera o terminal drenar
+            struct pollfd pfd = { 1, POLLOUT, 0 };
+            if (poll(&pfd, 1, 100) <= 0) break;
+            continue;
+        }
+        if (n <= 0) break;
+        total += (int)n;
+    }
+    return total;
 #endif
 }
 
@@ -91,4 +238,154 @@ int utils_random_int(int min_value, int max_value) {
     if (max_value <= min_value) return min_value;
     int span = max_value - min_value + 1;
     return min_value + (rand() % span);
-}
\ No newline at end of file
+}
+
+double utils_now_seconds(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+long long utils_rss_bytes(void) {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return -1;
+    return (long long)pmc.WorkingSetSize;
+#else
+    // /proc/self/statm: tamanho total e residente, em páginas
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (!f) return -1;
+    long pages_total = 0, pages_resident = 0;
+    int ok = (fscanf(f, "%ld %ld", &pages_total, &pages_resident) == 2);
+    fclose(f);
+    if (!ok) return -1;
+    return (long long)pages_resident * sysconf(_SC_PAGESIZE);
+#endif
+}
+
+int utils_fsync_file(FILE *f) {
+    if (!f || fflush(f) != 0) return 0;
+#ifdef _WIN32
+    return _commit(_fileno(f)) == 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+int utils_replace_file(const char *src, const char *dst) {
+    if (!src || !dst) return 0;
+#ifdef _WIN32
+    return MoveFileExA(src, dst, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(src, dst) == 0;
+#endif
+}
+
+int utils_map_file(const char *path, UtilsMapping *map) {
+    if (!path || !map) return 0;
+    memset(map, 0, sizeof(*map));
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return 0;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return 0;
+    }
+    map->size = (long long)size.QuadPart;
+    if (map->size == 0) {
+        CloseHandle(file);
+        return 1;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    const void *data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!data) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return 0;
+    }
+    map->file = file;
+    map->mapping = mapping;
+    map->data = data;
+    return 1;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return 0;
+    }
+    map->size = (long long)st.st_size;
+    if (map->size > 0) {
+        void *data = mmap(NULL, (size_t)map->size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return 0;
+        }
+        map->data = data;
+    }
+    close(fd);              // o mapeamento continua válido sem o descritor
+    return 1;
+#endif
+}
+
+void utils_unmap_file(UtilsMapping *map) {
+    if (!map) return;
+#ifdef _WIN32
+    if (map->data) UnmapViewOfFile(map->data);
+    if (map->mapping) CloseHandle((HANDLE)map->mapping);
+    if (map->file) CloseHandle((HANDLE)map->file);
+#else
+    if (map->data) munmap((void *)map->data, (size_t)map->size);
+#endif
+    memset(map, 0, sizeof(*map));
+}
+
+#ifdef _WIN32
+static DWORD WINAPI utils_thread_trampoline(LPVOID param) {
+    UtilsThread *thread = (UtilsThread *)param;
+    thread->fn(thread->arg);
+    return 0;
+}
+#else
+static void *utils_thread_trampoline(void *param) {
+    UtilsThread *thread = (UtilsThread *)param;
+    thread->fn(thread->arg);
+    return NULL;
+}
+#endif
+
+int utils_thread_start(UtilsThread *thread, void (*fn)(void *arg), void *arg) {
+    if (!thread || !fn) return 0;
+    thread->fn = fn;
+    thread->arg = arg;
+#ifdef _WIN32
+    thread->handle = CreateThread(NULL, 0, utils_thread_trampoline, thread, 0, NULL);
+    return thread->handle != NULL;
+#else
+    return pthread_create(&thread->handle, NULL, utils_thread_trampoline, thread) == 0;
+#endif
+}
+
+void utils_thread_join(UtilsThread *thread) {
+    if (!thread) return;
+#ifdef _WIN32
+    if (thread->handle) {
+        WaitForSingleObject((HANDLE)thread->handle, INFINITE);
+        CloseHandle((HANDLE)thread->handle);
+        thread->handle = NULL;
+    }
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+}
@@ -1,8 +1,13 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <stdio.h>
 #include <time.h>
 
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
 // Cross-platform utilities for input, timing and screen control.
 
 void utils_sleep_ms(int ms);
@@ -16,11 +21,76 @@ void utils_enable_raw_mode(void);
 void utils_disable_raw_mode(void);
 
 // Returns -1 if no key available; otherwise returns uppercase ASCII of the key.
+// Arrow keys are returned as 'W', 'A', 'S', 'D'.
 int utils_read_key_nonblock(void);
 
+// One decoded key press and the monotonic time (utils_now_seconds) it was read.
+typedef struct UtilsKeyEvent {
+    int key;      // uppercase ASCII; arrows mapped to W/A/S/D; 27 = ESC
+    double time;
+} UtilsKeyEvent;
+
+// Drains every pending input byte with a single read() and decodes it into events.
+// If nothing is pending, waits up to timeout_ms for input (0 = don't wait, <0 = forever),
+// so a loop can sleep until either a key arrives or its next tick deadline.
+// Returns the number of events written to out (at most max_events; the rest stays buffered).
+int utils_read_keys(UtilsKeyEvent *out, int max_events, int timeout_ms);
+
+// Writes the whole buffer to stdout with a single write()/WriteFile call when possible.
+// Returns the number of bytes written.
+int utils_write_stdout(const char *buf, int len);
+
 // Returns integer in [min, max].
 int utils_random_int(int min_value, int max_value);
 
+// Monotonic high-resolution clock, in seconds (arbitrary origin).
+double utils_now_seconds(void);
+
+// Resident set size of the current process in bytes, or -1 if unavailable.
+long long utils_rss_bytes(void);
+
+// Flushes f's stdio buffer and forces the data to disk (fsync / _commit). Returns 1 on success.
+// Slow (can take milliseconds): keep it off the render thread.
+int utils_fsync_file(FILE *f);
+
+// Atomically replaces dst with src (rename; MoveFileEx on Windows, which won't overwrite
+// with plain rename). Readers see either the old or the new file, never a partial one.
+int utils_replace_file(const char *src, const char *dst);
+
+// Read-only memory mapping of a whole file (mmap / MapViewOfFile).
+typedef struct UtilsMapping {
+    const void *data;       // NULL if not mapped (or the file is empty)
+    long long size;
+#ifdef _WIN32
+    void *file;
+    void *mapping;
+#endif
+} UtilsMapping;
+
+// Maps path read-only. Returns 1 on success (an empty file succeeds with data == NULL).
+int utils_map_file(const char *path, UtilsMapping *map);
+
+// Releases the mapping (safe to call on a zeroed/failed one).
+void utils_unmap_file(UtilsMapping *map);
+
+// Minimal portable thread handle (CreateThread on Windows, pthreads elsewhere).
+typedef struct UtilsThread {
+    void (*fn)(void *arg);
+    void *arg;
+#ifdef _WIN32
+    void *handle;
+#else
+    pthread_t handle;
+#endif
+} UtilsThread;
+
+// Starts fn(arg) on a new thread. Returns 1 on success, 0 on failure.
+// The UtilsThread must stay alive until utils_thread_join.
+int utils_thread_start(UtilsThread *thread, void (*fn)(void *arg), void *arg);
+
+// Waits for the thread to finish and releases its handle.
+void utils_thread_join(UtilsThread *thread);
+
 #endif // UTILS_H
 
 